@@ -0,0 +1,221 @@
+#pragma once
+
+#include <Echo\WinInclude.h>
+#include <Echo\WaitHandle.h>
+#include <Echo\SpinWait.h>
+
+#include <atomic>
+#include <chrono>
+
+// WaitOnAddress and friends live in the synchronization api set
+#pragma comment(lib, "Synchronization.lib")
+
+namespace Echo
+{
+
+/**
+ * Allows a thread to block until the value at an address changes.
+ * This is the building block for the user-space locks and events,
+ * which only need to involve the kernel when a thread actually has to sleep
+ */
+class AddressWaiter final
+{
+public:
+	AddressWaiter() = delete;
+	AddressWaiter(const AddressWaiter&) = delete;
+	AddressWaiter &operator=(const AddressWaiter&) = delete;
+
+	/**
+	 * Blocks while the value at an address equals a comparison value.
+	 * The wait may return spuriously, so callers must recheck their condition
+	 * @param address  the value to watch
+	 * @param compareValue  the value that indicates the caller should keep waiting
+	 * @param duration  how long to wait for
+	 * @returns true if woken (or the value had already changed), false on timeout
+	 */
+	template<typename T>
+	static bool Wait(const std::atomic<T> &address, T compareValue, const std::chrono::milliseconds &duration)
+	{
+		static_assert(sizeof(std::atomic<T>) == sizeof(T), "the atomic must be lock-free and the same size as its value");
+		static_assert(sizeof(T) == 1 || sizeof(T) == 2 || sizeof(T) == 4 || sizeof(T) == 8, "WaitOnAddress supports 1, 2, 4 or 8 byte values");
+
+		DWORD ms = static_cast<DWORD>(duration.count());
+		auto watched = const_cast<std::atomic<T>*>(&address);
+
+		BOOL success = ::WaitOnAddress(watched, &compareValue, sizeof(T), ms);
+		if(success) return true;
+
+		DWORD lastError = ::GetLastError();
+		if(lastError == ERROR_TIMEOUT) return false;
+
+		throw WindowsException(_T("WaitOnAddress failed"));
+	}
+
+	/**
+	 * Blocks while the value at an address equals a comparison value.
+	 * The wait may return spuriously, so callers must recheck their condition
+	 * @param address  the value to watch
+	 * @param compareValue  the value that indicates the caller should keep waiting
+	 */
+	template<typename T>
+	static void Wait(const std::atomic<T> &address, T compareValue)
+	{
+		Wait(address, compareValue, Infinite);
+	}
+
+	/**
+	 * Spins, then parks, until a condition over a value holds.
+	 * Threads that change the value must wake the address when the waiter count is non-zero,
+	 * reading the count after their change with sequentially consistent ordering
+	 * @param address  the value to watch
+	 * @param waiters  counts the threads parked on the address
+	 * @param spinCount  how many pause instructions to spin for before parking
+	 * @param duration  how long to wait for
+	 * @param done  returns true when given a value that ends the wait
+	 * @returns true if the condition holds, false on timeout
+	 */
+	template<typename T, typename PRED>
+	static bool WaitUntil(const std::atomic<T> &address, std::atomic<LONG> &waiters, unsigned spinCount, const std::chrono::milliseconds &duration, PRED done)
+	{
+		if(done(address.load(std::memory_order_acquire))) return true;
+		if(duration.count() == 0) return false;
+
+		SpinWait spinner;
+		while(spinner.TotalPauses() < spinCount)
+		{
+			spinner.SpinOnce();
+			if(done(address.load(std::memory_order_acquire))) return true;
+		}
+
+		const bool infinite = (duration == Infinite);
+		const auto deadline = std::chrono::steady_clock::now() + duration;
+
+		for(;;)
+		{
+			// Advertise ourselves before the final check, so a waker either sees us or we see its change
+			waiters.fetch_add(1, std::memory_order_seq_cst);
+
+			T value = address.load(std::memory_order_seq_cst);
+			if(done(value))
+			{
+				waiters.fetch_sub(1, std::memory_order_relaxed);
+				return true;
+			}
+
+			auto remaining = std::chrono::milliseconds(INFINITE);
+			if(!infinite)
+			{
+				auto left = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now());
+				remaining = (left.count() > 0 ? left : std::chrono::milliseconds(0));
+			}
+
+			bool woken = false;
+
+			try
+			{
+				woken = Wait(address, value, remaining);
+			}
+			catch(...)
+			{
+				waiters.fetch_sub(1, std::memory_order_relaxed);
+				throw;
+			}
+
+			waiters.fetch_sub(1, std::memory_order_relaxed);
+
+			if(woken == false) return done(address.load(std::memory_order_acquire));
+		}
+	}
+
+	/**
+	 * Spins, then parks, until a condition over a value holds. The value shares its atomic word with a flag
+	 * that parked threads set, and the thread that ends the wait replaces the word with an atomic exchange or CAS
+	 * that clears the flag. Because it learns from that same operation whether to wake anyone it never reads
+	 * the owning object after publishing the change, so a waiter may destroy the object as soon as this returns.
+	 * The waker passes only the address to WakeAll, which doesn't touch the memory
+	 * @param state  the value combined with the waiter flag
+	 * @param waiterFlag  the bit parked threads set, which must not be part of the value
+	 * @param spinCount  how many pause instructions to spin for before parking
+	 * @param duration  how long to wait for
+	 * @param done  returns true when given a value (without the flag) that ends the wait
+	 * @returns true if the condition holds, false on timeout
+	 */
+	template<typename T, typename PRED>
+	static bool WaitUntilFlagged(const std::atomic<T> &state, T waiterFlag, unsigned spinCount, const std::chrono::milliseconds &duration, PRED done)
+	{
+		const T valueMask = static_cast<T>(~waiterFlag);
+
+		if(done(static_cast<T>(state.load(std::memory_order_acquire) & valueMask))) return true;
+		if(duration.count() == 0) return false;
+
+		SpinWait spinner;
+		while(spinner.TotalPauses() < spinCount)
+		{
+			spinner.SpinOnce();
+			if(done(static_cast<T>(state.load(std::memory_order_acquire) & valueMask))) return true;
+		}
+
+		const bool infinite = (duration == Infinite);
+		const auto deadline = std::chrono::steady_clock::now() + duration;
+		auto &watched = const_cast<std::atomic<T>&>(state);
+
+		for(;;)
+		{
+			T value = watched.load(std::memory_order_acquire);
+			if(done(static_cast<T>(value & valueMask))) return true;
+
+			// Advertise ourselves in the same word as the value, so the thread that changes it sees us
+			if((value & waiterFlag) == 0 && watched.compare_exchange_weak(value, static_cast<T>(value | waiterFlag), std::memory_order_acq_rel, std::memory_order_acquire) == false)
+			{
+				continue;
+			}
+
+			auto remaining = std::chrono::milliseconds(INFINITE);
+			if(!infinite)
+			{
+				auto left = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now());
+				remaining = (left.count() > 0 ? left : std::chrono::milliseconds(0));
+			}
+
+			if(Wait(state, static_cast<T>(value | waiterFlag), remaining) == false)
+			{
+				return done(static_cast<T>(state.load(std::memory_order_acquire) & valueMask));
+			}
+		}
+	}
+
+	/**
+	 * Spins, then parks, until a count reaches zero. This is WaitUntilFlagged for a count,
+	 * where the thread that takes the count to zero stores zero, clearing the flag
+	 * @param state  the count combined with the waiter flag
+	 * @param waiterFlag  the bit parked threads set, which must be above any count
+	 * @param spinCount  how many pause instructions to spin for before parking
+	 * @param duration  how long to wait for
+	 * @returns true if the count reached zero, false on timeout
+	 */
+	template<typename T>
+	static bool WaitForZero(const std::atomic<T> &state, T waiterFlag, unsigned spinCount, const std::chrono::milliseconds &duration)
+	{
+		return WaitUntilFlagged(state, waiterFlag, spinCount, duration, [](T count){return count == 0;});
+	}
+
+	/**
+	 * Wakes one thread waiting on an address
+	 */
+	template<typename T>
+	static void WakeOne(const std::atomic<T> &address) noexcept
+	{
+		::WakeByAddressSingle(const_cast<std::atomic<T>*>(&address));
+	}
+
+	/**
+	 * Wakes all threads waiting on an address
+	 */
+	template<typename T>
+	static void WakeAll(const std::atomic<T> &address) noexcept
+	{
+		::WakeByAddressAll(const_cast<std::atomic<T>*>(&address));
+	}
+};
+
+} // end of namespace
\ No newline at end of file
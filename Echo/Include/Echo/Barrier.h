@@ -0,0 +1,136 @@
+#pragma once
+
+#include <Echo\WinInclude.h>
+#include <Echo\Exceptions.h>
+#include <Echo\WaitHandle.h>
+#include <Echo\OnDestruct.h>
+#include <Echo\AddressWaiter.h>
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+
+namespace Echo
+{
+
+/**
+ * A reusable rendezvous point for a fixed number of participants.
+ * Each participant arrives and waits until all of them have arrived, at which point the
+ * optional completion function runs on the last thread to arrive and everyone moves on to the next phase
+ */
+class Barrier
+{
+private:
+	/**
+	 * Set in m_Phase whilst threads are parked, so that the phase and the need to wake share one word.
+	 * The phase itself is held in the bits above it
+	 */
+	static const ULONG WaiterFlag = 1;
+	static const ULONG PhaseIncrement = 2;
+
+	const LONG m_ParticipantCount;
+	const std::function<void()> m_Completion;
+	const unsigned m_SpinCount;
+
+	std::atomic<LONG> m_Remaining;
+	std::atomic<ULONG> m_Phase;
+
+	/**
+	 * Registers an arrival, finishing the phase if we're the last one
+	 * @param phase  receives the phase we arrived in
+	 * @returns true if we finished the phase, so there is nothing to wait for
+	 */
+	bool Arrive(ULONG &phase)
+	{
+		phase = m_Phase.load(std::memory_order_acquire) & ~WaiterFlag;
+		if(m_Remaining.fetch_sub(1, std::memory_order_acq_rel) != 1) return false;
+
+		// Move everyone on even if the completion function throws
+		OnDestruct advance([this, phase]
+		{
+			m_Remaining.store(m_ParticipantCount, std::memory_order_relaxed);
+
+			// Only the last arriver changes the phase, so the exchange just has to clear the waiter flag.
+			// A waiter may destroy the barrier as soon as it sees the new phase, so only the address is used from here on
+			auto &address = m_Phase;
+			if((address.exchange(phase + PhaseIncrement, std::memory_order_acq_rel) & WaiterFlag) != 0)
+			{
+				AddressWaiter::WakeAll(address);
+			}
+		});
+
+		if(m_Completion) m_Completion();
+		return true;
+	}
+
+public:
+	/**
+	 * The default number of pause instructions a participant spins for before parking
+	 */
+	static const unsigned DefaultSpinCount = 1000;
+
+	/**
+	 * Initializes the instance
+	 * @param participantCount  the number of participants
+	 * @param completion  an optional function to run when each phase completes
+	 * @param spinCount  how many pause instructions to spin for before parking
+	 */
+	explicit Barrier(LONG participantCount, const std::function<void()> &completion = nullptr, unsigned spinCount = DefaultSpinCount) : m_ParticipantCount(participantCount), m_Completion(completion), m_SpinCount(spinCount), m_Remaining(participantCount), m_Phase(0)
+	{
+		if(participantCount <= 0) throw ArgumentException(_T("participantCount must be greater than zero"));
+	}
+
+	Barrier(const Barrier&) = delete;
+	Barrier(Barrier&&) = delete;
+
+	Barrier &operator=(const Barrier&) = delete;
+	Barrier &operator=(Barrier&&) = delete;
+
+	/**
+	 * Returns the number of participants
+	 */
+	LONG ParticipantCount() const noexcept
+	{
+		return m_ParticipantCount;
+	}
+
+	/**
+	 * Returns the number of participants yet to arrive in the current phase
+	 */
+	LONG ParticipantsRemaining() const noexcept
+	{
+		return m_Remaining.load(std::memory_order_acquire);
+	}
+
+	/**
+	 * Returns the number of phases that have completed, modulo 2^31
+	 */
+	ULONG Phase() const noexcept
+	{
+		return m_Phase.load(std::memory_order_acquire) / PhaseIncrement;
+	}
+
+	/**
+	 * Arrives at the barrier and waits forever for the other participants
+	 */
+	void ArriveAndWait()
+	{
+		ArriveAndWait(Infinite);
+	}
+
+	/**
+	 * Arrives at the barrier and waits for the other participants.
+	 * A timed out arrival still counts towards the phase, so the caller mustn't arrive again in it
+	 * @param duration  how long to wait for
+	 * @returns true if the phase completed, false on timeout
+	 */
+	bool ArriveAndWait(const std::chrono::milliseconds &duration)
+	{
+		ULONG phase = 0;
+		if(Arrive(phase)) return true;
+
+		return AddressWaiter::WaitUntilFlagged(m_Phase, WaiterFlag, m_SpinCount, duration, [phase](ULONG current){return current != phase;});
+	}
+};
+
+} // end of namespace
\ No newline at end of file
@@ -2,38 +2,166 @@
 
 #include <utility>
 #include <cstdint>
+#include <malloc.h>
+#include <new>
 #include <Echo\WinInclude.h>
+#include <Echo\Exceptions.h>
+#include <Echo\Environment.h>
+#include <Echo\LargePages.h>
 
 namespace Echo
 {
 
 /**
- * A class that manages a buffer
+ * Interface for a class that owns the memory behind a Buffer
+ * and wants it back when the buffer is destroyed
+ */
+class IBufferReleaser
+{
+public:
+	/**
+	 * Destroys the instance
+	 */
+	virtual ~IBufferReleaser()
+	{
+
+	}
+
+	/**
+	 * Takes back the memory of a destroyed buffer
+	 */
+	virtual void ReleaseBuffer(void *data, size_t size) noexcept = 0;
+};
+
+/**
+ * A class that manages a buffer.
+ * The memory is aligned to at least the requested alignment, so page aligned buffers
+ * can be used for unbuffered I/O and cache line aligned ones for vector loads
  */
 class Buffer
 {
 private:
+	/**
+	 * Frees memory obtained from VirtualAlloc
+	 */
+	class VirtualMemoryReleaser : public IBufferReleaser
+	{
+	public:
+		void ReleaseBuffer(void *data, size_t) noexcept override
+		{
+			::VirtualFree(data, 0, MEM_RELEASE);
+		}
+	};
+
 	std::uint8_t *m_Data;
 	size_t m_Size;
+	size_t m_Alignment;
+	IBufferReleaser *m_Releaser;
+	PageMode m_Pages;
+
+	Buffer(void *data, size_t size, size_t alignment, IBufferReleaser *releaser, PageMode pages = PageMode::Standard) noexcept : m_Data(static_cast<std::uint8_t*>(data)), m_Size(size), m_Alignment(alignment), m_Releaser(releaser), m_Pages(pages)
+	{
+	}
+
+	static IBufferReleaser &VirtualMemory() noexcept
+	{
+		static VirtualMemoryReleaser releaser;
+		return releaser;
+	}
+
+	void Release() noexcept
+	{
+		if(m_Data == nullptr) return;
+
+		if(m_Releaser != nullptr)
+		{
+			m_Releaser->ReleaseBuffer(m_Data, m_Size);
+		}
+		else
+		{
+			::_aligned_free(m_Data);
+		}
+	}
+
+	void Swap(Buffer &rhs) noexcept
+	{
+		std::swap(m_Data, rhs.m_Data);
+		std::swap(m_Size, rhs.m_Size);
+		std::swap(m_Alignment, rhs.m_Alignment);
+		std::swap(m_Releaser, rhs.m_Releaser);
+		std::swap(m_Pages, rhs.m_Pages);
+	}
 
 public:
+	/**
+	 * The alignment used when none is specified, which is what the heap guarantees anyway
+	 */
+	static const size_t DefaultAlignment = MEMORY_ALLOCATION_ALIGNMENT;
+
 	/**
 	 * Initializes the instance
 	 * @param size  the size of the buffer, in bytes
+	 * @param alignment  the alignment of the buffer, which must be a power of two
 	 */
-	explicit Buffer(size_t size)
+	explicit Buffer(size_t size, size_t alignment = DefaultAlignment) : m_Data(nullptr), m_Size(size), m_Alignment(alignment), m_Releaser(nullptr), m_Pages(PageMode::Standard)
 	{
-		m_Data = new std::uint8_t[size];
-		m_Size = size;
+		if(alignment == 0 || (alignment & (alignment - 1)) != 0) throw ArgumentException(_T("alignment must be a power of two"));
+
+		// Always allocate something so that Data is never null for a live buffer
+		m_Data = static_cast<std::uint8_t*>(::_aligned_malloc(size == 0 ? 1 : size, alignment));
+		if(m_Data == nullptr) throw std::bad_alloc();
+	}
+
+	/**
+	 * Creates a page aligned buffer, suitable for unbuffered I/O
+	 * @param size  the size of the buffer, in bytes
+	 */
+	static Buffer ForIO(size_t size)
+	{
+		return Buffer(size, Environment::PageSize());
+	}
+
+	/**
+	 * Creates a buffer backed by large pages if the process can allocate them,
+	 * otherwise by standard pages. Pages() reports which was used.
+	 * The allocation is rounded up to a whole number of pages
+	 * @param size  the size of the buffer, in bytes
+	 */
+	static Buffer WithLargePages(size_t size)
+	{
+		const size_t wanted = (size == 0 ? 1 : size);
+
+		if(LargePages::IsAvailable())
+		{
+			// Large pages can fail even with the privilege if physical memory is too fragmented
+			void *data = ::VirtualAlloc(nullptr, LargePages::RoundUp(wanted), MEM_COMMIT | MEM_RESERVE | MEM_LARGE_PAGES, PAGE_READWRITE);
+			if(data != nullptr) return Buffer(data, size, LargePages::MinimumSize(), &VirtualMemory(), PageMode::Large);
+		}
+
+		void *data = ::VirtualAlloc(nullptr, wanted, MEM_COMMIT | MEM_RESERVE, PAGE_READWRITE);
+		if(data == nullptr) throw std::bad_alloc();
+
+		return Buffer(data, size, Environment::PageSize(), &VirtualMemory(), PageMode::Standard);
+	}
+
+	/**
+	 * Creates a buffer around memory owned by someone else, which is handed back to them when the buffer is destroyed
+	 * @param data  the memory
+	 * @param size  the size of the memory, in bytes
+	 * @param alignment  the alignment of the memory
+	 * @param releaser  the owner of the memory
+	 */
+	static Buffer Adopt(void *data, size_t size, size_t alignment, IBufferReleaser &releaser) noexcept
+	{
+		return Buffer(data, size, alignment, &releaser);
 	}
 
 	/**
 	 * Initializes the instance via a move
 	 */
-	Buffer(Buffer &&rhs) : m_Data(nullptr), m_Size(0)
+	Buffer(Buffer &&rhs) noexcept : m_Data(nullptr), m_Size(0), m_Alignment(DefaultAlignment), m_Releaser(nullptr), m_Pages(PageMode::Standard)
 	{
-		std::swap(m_Data, rhs.m_Data);
-		std::swap(m_Size, rhs.m_Size);
+		Swap(rhs);
 	}
 
 	Buffer(const Buffer &&) = delete;	
@@ -47,24 +175,26 @@ public:
 	{
 		if(this != &rhs)
 		{
-			delete []m_Data;
+			Release();
 
 			m_Data = nullptr;
 			m_Size = 0;
+			m_Alignment = DefaultAlignment;
+			m_Releaser = nullptr;
+			m_Pages = PageMode::Standard;
 
-			std::swap(m_Data, rhs.m_Data);
-			std::swap(m_Size, rhs.m_Size);
+			Swap(rhs);
 		}
 
 		return *this;
 	}
 
 	/**
-	 * Destroys the instance by deleting the buffer
+	 * Destroys the instance by releasing the buffer
 	 */
 	~Buffer()
 	{
-		delete []m_Data;
+		Release();
 	}
 
 	/**
@@ -91,6 +221,33 @@ public:
 		return m_Size;
 	}
 
+	/**
+	 * Reduces the size of the buffer without reallocating it.
+	 * The memory beyond the new size is still owned by the buffer
+	 * @param size  the new size, in bytes, which must not be larger than the current size
+	 */
+	void Truncate(size_t size)
+	{
+		if(size > m_Size) throw ArgumentException(_T("size is larger than the buffer"));
+		m_Size = size;
+	}
+
+	/**
+	 * Returns the alignment the buffer was allocated with
+	 */
+	size_t Alignment() const noexcept
+	{
+		return m_Alignment;
+	}
+
+	/**
+	 * Returns the kind of pages backing the buffer
+	 */
+	PageMode Pages() const noexcept
+	{
+		return m_Pages;
+	}
+
 	/**
 	 * Returns a pointer to the buffer
 	 */
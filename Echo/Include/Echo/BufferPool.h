@@ -0,0 +1,96 @@
+#pragma once
+
+#include <Echo\Buffer.h>
+#include <Echo\SlabPool.h>
+#include <Echo\Environment.h>
+
+namespace Echo
+{
+
+/**
+ * Hands out fixed size, aligned buffers so that I/O paths don't allocate for every operation.
+ * The buffers are carved from slabs and cached per thread by a SlabPool, and go back to
+ * the pool automatically when the Buffer is destroyed.
+ *
+ * The pool must outlive the buffers it hands out
+ */
+class BufferPool : private IBufferReleaser
+{
+private:
+	const size_t m_BufferSize;
+	SlabPool m_Slabs;
+
+	void ReleaseBuffer(void *data, size_t) noexcept override
+	{
+		m_Slabs.Free(data);
+	}
+
+public:
+	/**
+	 * Initializes the instance with page aligned buffers
+	 * @param bufferSize  the size of each buffer, in bytes
+	 */
+	explicit BufferPool(size_t bufferSize) : BufferPool(bufferSize, Environment::PageSize())
+	{
+	}
+
+	/**
+	 * Initializes the instance
+	 * @param bufferSize  the size of each buffer, in bytes
+	 * @param alignment  the alignment of each buffer, which must be a power of two
+	 * @param preallocate  the number of buffers to allocate up front
+	 */
+	BufferPool(size_t bufferSize, size_t alignment, size_t preallocate = 0) : m_BufferSize(bufferSize), m_Slabs(bufferSize, alignment, preallocate)
+	{
+	}
+
+	BufferPool(const BufferPool&) = delete;
+	BufferPool(BufferPool&&) = delete;
+
+	BufferPool &operator=(const BufferPool&) = delete;
+	BufferPool &operator=(BufferPool&&) = delete;
+
+	/**
+	 * Returns the size of each buffer, in bytes
+	 */
+	size_t BufferSize() const noexcept
+	{
+		return m_BufferSize;
+	}
+
+	/**
+	 * Returns the alignment of each buffer
+	 */
+	size_t Alignment() const noexcept
+	{
+		return m_Slabs.Alignment();
+	}
+
+	/**
+	 * Returns the number of buffers the pool has allocated from the heap
+	 */
+	size_t Capacity() const noexcept
+	{
+		return m_Slabs.Capacity();
+	}
+
+	/**
+	 * Allocates at least count more buffers
+	 * @param count  the number of buffers
+	 */
+	void Reserve(size_t count)
+	{
+		m_Slabs.Reserve(count);
+	}
+
+	/**
+	 * Takes a buffer from the pool. Its contents are undefined
+	 * @returns a buffer that returns to the pool when destroyed
+	 */
+	Buffer Acquire()
+	{
+		return Buffer::Adopt(m_Slabs.Allocate(), m_BufferSize, m_Slabs.Alignment(), *this);
+	}
+};
+
+} // end of namespace
\ No newline at end of file
@@ -0,0 +1,383 @@
+#pragma once
+
+#include <Echo\WinInclude.h>
+#include <Echo\Buffer.h>
+#include <Echo\Exceptions.h>
+#include <Echo\IReaderWriter.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <utility>
+
+namespace Echo
+{
+
+/**
+ * A growable byte buffer for encoding and decoding data in place.
+ *
+ * Bytes are appended at the end and read from a separate read cursor. Unlike a
+ * std::vector growing the buffer never zero fills, and the finished contents can be
+ * detached into a Buffer without copying. As an IReaderWriter it can be handed
+ * straight to code that normally writes to a File
+ */
+class ByteBuffer : public IReaderWriter
+{
+private:
+	Buffer m_Storage;
+	size_t m_Alignment;
+	size_t m_Size;
+	size_t m_ReadPosition;
+
+	std::uint8_t *Bytes() noexcept
+	{
+		return m_Storage.DataAs<std::uint8_t>();
+	}
+
+	const std::uint8_t *Bytes() const noexcept
+	{
+		return m_Storage.DataAs<std::uint8_t>();
+	}
+
+	void EnsureCapacity(size_t required)
+	{
+		if(required <= Capacity()) return;
+
+		// Grow geometrically so that repeated appends are amortized constant time
+		Reserve((std::max)(required, Capacity() * 2));
+	}
+
+public:
+	/**
+	 * Initializes the instance
+	 * @param initialCapacity  the number of bytes to allocate up front
+	 * @param alignment  the alignment of the underlying storage, which must be a power of two
+	 */
+	explicit ByteBuffer(size_t initialCapacity = 0, size_t alignment = Buffer::DefaultAlignment) : m_Storage(initialCapacity, alignment), m_Alignment(alignment), m_Size(0), m_ReadPosition(0)
+	{
+	}
+
+	ByteBuffer(ByteBuffer &&rhs) noexcept : m_Storage(std::move(rhs.m_Storage)), m_Alignment(rhs.m_Alignment), m_Size(rhs.m_Size), m_ReadPosition(rhs.m_ReadPosition)
+	{
+		rhs.m_Size = 0;
+		rhs.m_ReadPosition = 0;
+	}
+
+	ByteBuffer(const ByteBuffer&) = delete;
+	ByteBuffer &operator=(const ByteBuffer&) = delete;
+
+	ByteBuffer &operator=(ByteBuffer &&rhs) noexcept
+	{
+		if(this != &rhs)
+		{
+			m_Storage = std::move(rhs.m_Storage);
+			m_Alignment = rhs.m_Alignment;
+			m_Size = rhs.m_Size;
+			m_ReadPosition = rhs.m_ReadPosition;
+
+			rhs.m_Size = 0;
+			rhs.m_ReadPosition = 0;
+		}
+
+		return *this;
+	}
+
+	/**
+	 * Returns the number of bytes in the buffer
+	 */
+	size_t Size() const noexcept
+	{
+		return m_Size;
+	}
+
+	/**
+	 * Returns the number of bytes the buffer can hold before it has to grow
+	 */
+	size_t Capacity() const noexcept
+	{
+		return m_Storage.Size();
+	}
+
+	/**
+	 * Indicates if the buffer is empty
+	 */
+	bool IsEmpty() const noexcept
+	{
+		return m_Size == 0;
+	}
+
+	/**
+	 * Returns a pointer to the start of the buffer
+	 */
+	void *Data() noexcept
+	{
+		return Bytes();
+	}
+
+	/**
+	 * Returns a pointer to the start of the buffer
+	 */
+	const void *Data() const noexcept
+	{
+		return Bytes();
+	}
+
+	/**
+	 * Returns a pointer to the start of the buffer as a specified type
+	 */
+	template<typename T>
+	T *DataAs() noexcept
+	{
+		return reinterpret_cast<T*>(Bytes());
+	}
+
+	/**
+	 * Returns a pointer to the start of the buffer as a specified type
+	 */
+	template<typename T>
+	const T *DataAs() const noexcept
+	{
+		return reinterpret_cast<const T*>(Bytes());
+	}
+
+	/**
+	 * Makes sure the buffer can hold at least the specified number of bytes without growing
+	 * @param capacity  the number of bytes
+	 */
+	void Reserve(size_t capacity)
+	{
+		if(capacity <= Capacity()) return;
+
+		Buffer storage(capacity, m_Alignment);
+		if(m_Size != 0) ::memcpy(storage.Data(), Bytes(), m_Size);
+
+		m_Storage = std::move(storage);
+	}
+
+	/**
+	 * Changes the size of the buffer without initializing any new bytes,
+	 * for when the caller is about to fill them in
+	 * @param size  the new size, in bytes
+	 */
+	void ResizeUninitialized(size_t size)
+	{
+		EnsureCapacity(size);
+
+		m_Size = size;
+		m_ReadPosition = (std::min)(m_ReadPosition, m_Size);
+	}
+
+	/**
+	 * Empties the buffer, keeping its capacity
+	 */
+	void Clear() noexcept
+	{
+		m_Size = 0;
+		m_ReadPosition = 0;
+	}
+
+	/**
+	 * Extends the buffer and returns the new bytes so they can be written in place
+	 * @param bytes  the number of bytes to add
+	 * @returns a pointer to the first new byte, which is only valid until the buffer next grows
+	 */
+	void *AppendUninitialized(size_t bytes)
+	{
+		size_t offset = m_Size;
+		ResizeUninitialized(m_Size + bytes);
+
+		return Bytes() + offset;
+	}
+
+	/**
+	 * Appends bytes to the buffer
+	 * @param data  the bytes to append
+	 * @param bytes  the number of bytes
+	 */
+	void Append(const void *data, size_t bytes)
+	{
+		if(bytes == 0) return;
+		if(data == nullptr) throw ArgumentNullException(_T("data"));
+
+		::memcpy(AppendUninitialized(bytes), data, bytes);
+	}
+
+	/**
+	 * Appends the bytes of a value to the buffer
+	 */
+	template<typename T>
+	void AppendValue(const T &value)
+	{
+		static_assert(std::is_trivially_copyable<T>::value, "T must be trivially copyable");
+		Append(&value, sizeof(T));
+	}
+
+	/**
+	 * Returns the offset of the read cursor
+	 */
+	size_t ReadPosition() const noexcept
+	{
+		return m_ReadPosition;
+	}
+
+	/**
+	 * Moves the read cursor
+	 * @param position  the new offset, which must not be beyond the end of the buffer
+	 */
+	void ReadPosition(size_t position)
+	{
+		if(position > m_Size) throw ArgumentException(_T("position is beyond the end of the buffer"));
+		m_ReadPosition = position;
+	}
+
+	/**
+	 * Returns the number of bytes between the read cursor and the end of the buffer
+	 */
+	size_t Remaining() const noexcept
+	{
+		return m_Size - m_ReadPosition;
+	}
+
+	/**
+	 * Copies bytes from the read cursor, advancing it
+	 * @param data  where to copy the bytes to
+	 * @param bytes  the maximum number of bytes to copy
+	 * @returns the number of bytes copied
+	 */
+	size_t ReadBytes(void *data, size_t bytes)
+	{
+		bytes = (std::min)(bytes, Remaining());
+		if(bytes == 0) return 0;
+
+		if(data == nullptr) throw ArgumentNullException(_T("data"));
+
+		::memcpy(data, Bytes() + m_ReadPosition, bytes);
+		m_ReadPosition += bytes;
+
+		return bytes;
+	}
+
+	/**
+	 * Reads a value from the read cursor, advancing it
+	 * @returns the value
+	 */
+	template<typename T>
+	T ReadValue()
+	{
+		static_assert(std::is_trivially_copyable<T>::value, "T must be trivially copyable");
+		if(Remaining() < sizeof(T)) throw Exception(_T("not enough data in the buffer"));
+
+		T value;
+		::memcpy(&value, Bytes() + m_ReadPosition, sizeof(T));
+		m_ReadPosition += sizeof(T);
+
+		return value;
+	}
+
+	/**
+	 * Hands the contents over as a Buffer whose size is the size of this buffer, without copying.
+	 * This buffer is left empty and will allocate again if written to
+	 */
+	Buffer Detach()
+	{
+		m_Storage.Truncate(m_Size);
+		Buffer buffer(std::move(m_Storage));
+
+		m_Size = 0;
+		m_ReadPosition = 0;
+
+		return buffer;
+	}
+
+	/**
+	 * Does nothing, as there is nothing to close
+	 */
+	virtual void Close() noexcept override
+	{
+	}
+
+	/**
+	 * Appends data to the buffer
+	 * @param buffer  a pointer to the data to write
+	 * @param bytesToWrite  how much data to write
+	 * @returns the number of bytes written
+	 */
+	virtual DWORD Write(const void *buffer, DWORD bytesToWrite) override
+	{
+		Append(buffer, bytesToWrite);
+		return bytesToWrite;
+	}
+
+	/**
+	 * Appends data to the buffer. This always completes immediately
+	 * @param buffer  a pointer to the data to write
+	 * @param bytesToWrite  how much data to write
+	 * @param overlapped  receives the number of bytes transferred
+	 * @returns Complete
+	 */
+	virtual AsyncResult WriteAsync(const void *buffer, DWORD bytesToWrite, OVERLAPPED &overlapped) override
+	{
+		overlapped.Internal = 0;
+		overlapped.InternalHigh = Write(buffer, bytesToWrite);
+
+		return AsyncResult::Complete;
+	}
+
+	/**
+	 * Appends several buffers, growing the storage at most once
+	 * @param segments  the buffers to append
+	 * @param count  the number of segments
+	 * @returns the total number of bytes written
+	 */
+	virtual DWORD WriteV(const ConstIoSegment *segments, size_t count) override
+	{
+		if(segments == nullptr && count != 0) throw ArgumentNullException(_T("segments"));
+
+		DWORD bytesToWrite = 0;
+		for(size_t i = 0; i < count; i++) bytesToWrite += segments[i].Size;
+
+		EnsureCapacity(m_Size + bytesToWrite);
+		for(size_t i = 0; i < count; i++) Append(segments[i].Data, segments[i].Size);
+
+		return bytesToWrite;
+	}
+
+	/**
+	 * Reads data from the read cursor
+	 * @param buffer  a pointer to where the read data will be stored
+	 * @param bytesToRead  how much data to read
+	 * @returns the number of bytes read, which is zero at the end of the buffer
+	 */
+	virtual DWORD Read(void *buffer, DWORD bytesToRead) override
+	{
+		return static_cast<DWORD>(ReadBytes(buffer, bytesToRead));
+	}
+
+	/**
+	 * Reads data from the read cursor. This always completes immediately
+	 * @param buffer  a pointer to where the read data will be stored
+	 * @param bytesToRead  how much data to read
+	 * @param overlapped  receives the number of bytes transferred
+	 * @returns Complete
+	 */
+	virtual AsyncResult ReadAsync(void *buffer, DWORD bytesToRead, OVERLAPPED &overlapped) override
+	{
+		overlapped.Internal = 0;
+		overlapped.InternalHigh = Read(buffer, bytesToRead);
+
+		return AsyncResult::Complete;
+	}
+
+	/**
+	 * Returns the result of an operation, which will already have completed
+	 * @param overlapped  the overlapped structure that was passed to the async operation
+	 * @returns the number of bytes transferred by the operation
+	 */
+	virtual DWORD WaitForAsyncToComplete(OVERLAPPED &overlapped) override
+	{
+		return static_cast<DWORD>(overlapped.InternalHigh);
+	}
+};
+
+} // end of namespace
\ No newline at end of file
@@ -0,0 +1,599 @@
+#pragma once
+
+#include <Echo\WinInclude.h>
+
+#include <intrin.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <utility>
+
+namespace Echo
+{
+
+/**
+ * The instruction set used by the byte kernels
+ */
+enum class SimdLevel
+{
+	Scalar,
+	Sse2,
+	Avx2,
+	Avx512
+};
+
+/**
+ * Vectorized routines for scanning and comparing blocks of bytes.
+ *
+ * The widest instruction set the processor and operating system support is picked
+ * on first use and every call after that goes straight to it.
+ *
+ * Each routine takes a pointer and a size, so it works on mapped views as well as buffers.
+ * There are also overloads for anything with Data() and Size(), such as Buffer,
+ * BufferSlice and ByteBuffer
+ */
+class ByteKernels final
+{
+private:
+	typedef std::uint8_t Byte;
+
+	struct Dispatch
+	{
+		SimdLevel Level;
+		bool HasCrc32;
+		size_t (*Mismatch)(const Byte*, const Byte*, size_t);
+		size_t (*Find)(const Byte*, size_t, Byte);
+		size_t (*FindPattern)(const Byte*, size_t, const Byte*, size_t);
+		size_t (*Count)(const Byte*, size_t, Byte);
+	};
+
+	template<typename T>
+	using EnableIfBuffer = decltype(std::declval<const T&>().Data(), std::declval<const T&>().Size());
+
+	static unsigned FirstSetBit(std::uint32_t mask) noexcept
+	{
+		unsigned long index = 0;
+		_BitScanForward(&index, mask);
+
+		return static_cast<unsigned>(index);
+	}
+
+	static unsigned FirstSetBit(std::uint64_t mask) noexcept
+	{
+		// Split in two so that this also works in 32 bit builds
+		auto low = static_cast<std::uint32_t>(mask);
+		if(low != 0) return FirstSetBit(low);
+
+		return 32 + FirstSetBit(static_cast<std::uint32_t>(mask >> 32));
+	}
+
+	static size_t Offset(size_t start, size_t found) noexcept
+	{
+		if(found == NotFound) return NotFound;
+		return start + found;
+	}
+
+	struct Scalar
+	{
+		static size_t Mismatch(const Byte *lhs, const Byte *rhs, size_t size) noexcept
+		{
+			for(size_t i = 0; i < size; i++)
+			{
+				if(lhs[i] != rhs[i]) return i;
+			}
+
+			return size;
+		}
+
+		static size_t Find(const Byte *data, size_t size, Byte value) noexcept
+		{
+			auto found = static_cast<const Byte*>(::memchr(data, value, size));
+			return (found == nullptr ? NotFound : static_cast<size_t>(found - data));
+		}
+
+		static size_t FindPattern(const Byte *data, size_t size, const Byte *pattern, size_t patternSize) noexcept
+		{
+			for(size_t i = 0; i + patternSize <= size; i++)
+			{
+				if(data[i] == pattern[0] && ::memcmp(data + i + 1, pattern + 1, patternSize - 1) == 0) return i;
+			}
+
+			return NotFound;
+		}
+
+		static size_t Count(const Byte *data, size_t size, Byte value) noexcept
+		{
+			size_t count = 0;
+
+			for(size_t i = 0; i < size; i++)
+			{
+				if(data[i] == value) count++;
+			}
+
+			return count;
+		}
+	};
+
+	struct Sse2
+	{
+		static __m128i Load(const Byte *address) noexcept
+		{
+			return _mm_loadu_si128(reinterpret_cast<const __m128i*>(address));
+		}
+
+		static std::uint32_t Equal(__m128i lhs, __m128i rhs) noexcept
+		{
+			return static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(lhs, rhs)));
+		}
+
+		static size_t Mismatch(const Byte *lhs, const Byte *rhs, size_t size) noexcept
+		{
+			size_t i = 0;
+
+			for(; i + 16 <= size; i += 16)
+			{
+				std::uint32_t different = Equal(Load(lhs + i), Load(rhs + i)) ^ 0xFFFF;
+				if(different != 0) return i + FirstSetBit(different);
+			}
+
+			return i + Scalar::Mismatch(lhs + i, rhs + i, size - i);
+		}
+
+		static size_t Find(const Byte *data, size_t size, Byte value) noexcept
+		{
+			const __m128i needle = _mm_set1_epi8(static_cast<char>(value));
+			size_t i = 0;
+
+			for(; i + 16 <= size; i += 16)
+			{
+				std::uint32_t matches = Equal(Load(data + i), needle);
+				if(matches != 0) return i + FirstSetBit(matches);
+			}
+
+			return Offset(i, Scalar::Find(data + i, size - i, value));
+		}
+
+		static size_t FindPattern(const Byte *data, size_t size, const Byte *pattern, size_t patternSize) noexcept
+		{
+			// Only check the whole pattern where both its first and last bytes match
+			const __m128i first = _mm_set1_epi8(static_cast<char>(pattern[0]));
+			const __m128i last = _mm_set1_epi8(static_cast<char>(pattern[patternSize - 1]));
+			const size_t positions = size - patternSize + 1;
+
+			size_t i = 0;
+
+			for(; i + 16 <= positions; i += 16)
+			{
+				std::uint32_t candidates = Equal(Load(data + i), first) & Equal(Load(data + i + patternSize - 1), last);
+
+				while(candidates != 0)
+				{
+					unsigned bit = FirstSetBit(candidates);
+					if(::memcmp(data + i + bit + 1, pattern + 1, patternSize - 2) == 0) return i + bit;
+
+					candidates &= candidates - 1;
+				}
+			}
+
+			return Offset(i, Scalar::FindPattern(data + i, size - i, pattern, patternSize));
+		}
+
+		static size_t Count(const Byte *data, size_t size, Byte value) noexcept
+		{
+			const __m128i needle = _mm_set1_epi8(static_cast<char>(value));
+			size_t count = 0;
+			size_t i = 0;
+
+			while(i + 16 <= size)
+			{
+				// A matching lane is all ones, so subtracting it adds one. Each lane can reach 255 before it wraps
+				size_t blocks = (std::min)((size - i) / 16, static_cast<size_t>(255));
+				__m128i counts = _mm_setzero_si128();
+
+				for(size_t block = 0; block < blocks; block++, i += 16)
+				{
+					counts = _mm_sub_epi8(counts, _mm_cmpeq_epi8(Load(data + i), needle));
+				}
+
+				alignas(16) std::uint64_t sums[2];
+				_mm_store_si128(reinterpret_cast<__m128i*>(sums), _mm_sad_epu8(counts, _mm_setzero_si128()));
+
+				count += static_cast<size_t>(sums[0] + sums[1]);
+			}
+
+			return count + Scalar::Count(data + i, size - i, value);
+		}
+	};
+
+	struct Avx2
+	{
+		static __m256i Load(const Byte *address) noexcept
+		{
+			return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(address));
+		}
+
+		static std::uint32_t Equal(__m256i lhs, __m256i rhs) noexcept
+		{
+			return static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(lhs, rhs)));
+		}
+
+		static size_t Mismatch(const Byte *lhs, const Byte *rhs, size_t size) noexcept
+		{
+			size_t i = 0;
+
+			for(; i + 32 <= size; i += 32)
+			{
+				std::uint32_t different = ~Equal(Load(lhs + i), Load(rhs + i));
+				if(different != 0) return i + FirstSetBit(different);
+			}
+
+			return i + Sse2::Mismatch(lhs + i, rhs + i, size - i);
+		}
+
+		static size_t Find(const Byte *data, size_t size, Byte value) noexcept
+		{
+			const __m256i needle = _mm256_set1_epi8(static_cast<char>(value));
+			size_t i = 0;
+
+			for(; i + 32 <= size; i += 32)
+			{
+				std::uint32_t matches = Equal(Load(data + i), needle);
+				if(matches != 0) return i + FirstSetBit(matches);
+			}
+
+			return Offset(i, Sse2::Find(data + i, size - i, value));
+		}
+
+		static size_t FindPattern(const Byte *data, size_t size, const Byte *pattern, size_t patternSize) noexcept
+		{
+			const __m256i first = _mm256_set1_epi8(static_cast<char>(pattern[0]));
+			const __m256i last = _mm256_set1_epi8(static_cast<char>(pattern[patternSize - 1]));
+			const size_t positions = size - patternSize + 1;
+
+			size_t i = 0;
+
+			for(; i + 32 <= positions; i += 32)
+			{
+				std::uint32_t candidates = Equal(Load(data + i), first) & Equal(Load(data + i + patternSize - 1), last);
+
+				while(candidates != 0)
+				{
+					unsigned bit = FirstSetBit(candidates);
+					if(::memcmp(data + i + bit + 1, pattern + 1, patternSize - 2) == 0) return i + bit;
+
+					candidates &= candidates - 1;
+				}
+			}
+
+			return Offset(i, Sse2::FindPattern(data + i, size - i, pattern, patternSize));
+		}
+
+		static size_t Count(const Byte *data, size_t size, Byte value) noexcept
+		{
+			const __m256i needle = _mm256_set1_epi8(static_cast<char>(value));
+			size_t count = 0;
+			size_t i = 0;
+
+			while(i + 32 <= size)
+			{
+				size_t blocks = (std::min)((size - i) / 32, static_cast<size_t>(255));
+				__m256i counts = _mm256_setzero_si256();
+
+				for(size_t block = 0; block < blocks; block++, i += 32)
+				{
+					counts = _mm256_sub_epi8(counts, _mm256_cmpeq_epi8(Load(data + i), needle));
+				}
+
+				alignas(32) std::uint64_t sums[4];
+				_mm256_store_si256(reinterpret_cast<__m256i*>(sums), _mm256_sad_epu8(counts, _mm256_setzero_si256()));
+
+				count += static_cast<size_t>(sums[0] + sums[1] + sums[2] + sums[3]);
+			}
+
+			return count + Sse2::Count(data + i, size - i, value);
+		}
+	};
+
+	/**
+	 * Needs AVX-512BW. Pattern search gains little from the wider registers, so it uses the AVX2 version
+	 */
+	struct Avx512
+	{
+		static __m512i Load(const Byte *address) noexcept
+		{
+			return _mm512_loadu_si512(address);
+		}
+
+		static size_t Mismatch(const Byte *lhs, const Byte *rhs, size_t size) noexcept
+		{
+			size_t i = 0;
+
+			for(; i + 64 <= size; i += 64)
+			{
+				std::uint64_t different = ~static_cast<std::uint64_t>(_mm512_cmpeq_epi8_mask(Load(lhs + i), Load(rhs + i)));
+				if(different != 0) return i + FirstSetBit(different);
+			}
+
+			return i + Avx2::Mismatch(lhs + i, rhs + i, size - i);
+		}
+
+		static size_t Find(const Byte *data, size_t size, Byte value) noexcept
+		{
+			const __m512i needle = _mm512_set1_epi8(static_cast<char>(value));
+			size_t i = 0;
+
+			for(; i + 64 <= size; i += 64)
+			{
+				std::uint64_t matches = _mm512_cmpeq_epi8_mask(Load(data + i), needle);
+				if(matches != 0) return i + FirstSetBit(matches);
+			}
+
+			return Offset(i, Avx2::Find(data + i, size - i, value));
+		}
+
+		static size_t Count(const Byte *data, size_t size, Byte value) noexcept
+		{
+			const __m512i needle = _mm512_set1_epi8(static_cast<char>(value));
+			size_t count = 0;
+			size_t i = 0;
+
+			for(; i + 64 <= size; i += 64)
+			{
+				std::uint64_t matches = _mm512_cmpeq_epi8_mask(Load(data + i), needle);
+				count += __popcnt(static_cast<unsigned int>(matches)) + __popcnt(static_cast<unsigned int>(matches >> 32));
+			}
+
+			return count + Avx2::Count(data + i, size - i, value);
+		}
+	};
+
+	static SimdLevel DetectLevel() noexcept
+	{
+		int info[4] = {};
+
+		__cpuid(info, 0);
+		const int highestLeaf = info[0];
+
+		__cpuid(info, 1);
+		const bool sse2 = (info[3] & (1 << 26)) != 0;
+		const bool osxsave = (info[2] & (1 << 27)) != 0;
+		const bool avx = (info[2] & (1 << 28)) != 0;
+
+		if(!sse2) return SimdLevel::Scalar;
+		if(!osxsave || !avx || highestLeaf < 7) return SimdLevel::Sse2;
+
+		// The operating system must be saving the wider registers on a context switch
+		const auto enabledState = _xgetbv(0);
+		if((enabledState & 0x06) != 0x06) return SimdLevel::Sse2;
+
+		__cpuidex(info, 7, 0);
+		const bool avx2 = (info[1] & (1 << 5)) != 0;
+		const bool avx512f = (info[1] & (1 << 16)) != 0;
+		const bool avx512bw = (info[1] & (1 << 30)) != 0;
+
+		if(avx512f && avx512bw && (enabledState & 0xE6) == 0xE6) return SimdLevel::Avx512;
+		return (avx2 ? SimdLevel::Avx2 : SimdLevel::Sse2);
+	}
+
+	static bool DetectCrc32() noexcept
+	{
+		int info[4] = {};
+		__cpuid(info, 1);
+
+		// SSE4.2
+		return (info[2] & (1 << 20)) != 0;
+	}
+
+	static Dispatch Select() noexcept
+	{
+		switch(DetectLevel())
+		{
+			case SimdLevel::Avx512:
+				return {SimdLevel::Avx512, DetectCrc32(), &Avx512::Mismatch, &Avx512::Find, &Avx2::FindPattern, &Avx512::Count};
+
+			case SimdLevel::Avx2:
+				return {SimdLevel::Avx2, DetectCrc32(), &Avx2::Mismatch, &Avx2::Find, &Avx2::FindPattern, &Avx2::Count};
+
+			case SimdLevel::Sse2:
+				return {SimdLevel::Sse2, DetectCrc32(), &Sse2::Mismatch, &Sse2::Find, &Sse2::FindPattern, &Sse2::Count};
+
+			default:
+				return {SimdLevel::Scalar, false, &Scalar::Mismatch, &Scalar::Find, &Scalar::FindPattern, &Scalar::Count};
+		}
+	}
+
+	static const Dispatch &Kernels() noexcept
+	{
+		static const Dispatch dispatch = Select();
+		return dispatch;
+	}
+
+	/**
+	 * The lookup table for the reflected Castagnoli polynomial
+	 */
+	struct Crc32cTable
+	{
+		std::uint32_t Values[256];
+
+		Crc32cTable() noexcept
+		{
+			for(std::uint32_t i = 0; i < 256; i++)
+			{
+				std::uint32_t crc = i;
+				for(int bit = 0; bit < 8; bit++) crc = (crc >> 1) ^ (0x82F63B78 & (0 - (crc & 1)));
+
+				Values[i] = crc;
+			}
+		}
+	};
+
+	static std::uint32_t Crc32cScalar(const Byte *data, size_t size, std::uint32_t crc) noexcept
+	{
+		static const Crc32cTable table;
+
+		for(size_t i = 0; i < size; i++)
+		{
+			crc = table.Values[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+		}
+
+		return crc;
+	}
+
+	static std::uint32_t Crc32cHardware(const Byte *data, size_t size, std::uint32_t crc) noexcept
+	{
+#if defined(_M_X64)
+		std::uint64_t crc64 = crc;
+
+		for(; size >= 8; data += 8, size -= 8)
+		{
+			std::uint64_t value;
+			::memcpy(&value, data, sizeof(value));
+			crc64 = _mm_crc32_u64(crc64, value);
+		}
+
+		crc = static_cast<std::uint32_t>(crc64);
+#endif
+
+		for(; size >= 4; data += 4, size -= 4)
+		{
+			std::uint32_t value;
+			::memcpy(&value, data, sizeof(value));
+			crc = _mm_crc32_u32(crc, value);
+		}
+
+		for(; size != 0; data++, size--)
+		{
+			crc = _mm_crc32_u8(crc, *data);
+		}
+
+		return crc;
+	}
+
+public:
+	/**
+	 * Returned by the find routines when there is no match
+	 */
+	static const size_t NotFound = static_cast<size_t>(-1);
+
+	ByteKernels() = delete;
+	ByteKernels(const ByteKernels&) = delete;
+	ByteKernels &operator=(const ByteKernels&) = delete;
+
+	/**
+	 * Returns the instruction set the kernels are using
+	 */
+	static SimdLevel Level() noexcept
+	{
+		return Kernels().Level;
+	}
+
+	/**
+	 * Returns the offset of the first byte that differs between two blocks
+	 * @returns the offset, or size if the blocks are the same
+	 */
+	static size_t Mismatch(const void *lhs, const void *rhs, size_t size) noexcept
+	{
+		return Kernels().Mismatch(static_cast<const Byte*>(lhs), static_cast<const Byte*>(rhs), size);
+	}
+
+	/**
+	 * Indicates if two blocks hold the same bytes
+	 */
+	static bool Equal(const void *lhs, const void *rhs, size_t size) noexcept
+	{
+		return Mismatch(lhs, rhs, size) == size;
+	}
+
+	/**
+	 * Returns the offset of the first occurrence of a byte
+	 * @returns the offset, or NotFound
+	 */
+	static size_t Find(const void *data, size_t size, std::uint8_t value) noexcept
+	{
+		return Kernels().Find(static_cast<const Byte*>(data), size, value);
+	}
+
+	/**
+	 * Returns the offset of the first occurrence of a sequence of bytes
+	 * @returns the offset, or NotFound. An empty pattern is found at offset zero
+	 */
+	static size_t FindPattern(const void *data, size_t size, const void *pattern, size_t patternSize) noexcept
+	{
+		if(patternSize == 0) return 0;
+		if(patternSize > size) return NotFound;
+
+		auto bytes = static_cast<const Byte*>(pattern);
+		if(patternSize == 1) return Find(data, size, bytes[0]);
+
+		return Kernels().FindPattern(static_cast<const Byte*>(data), size, bytes, patternSize);
+	}
+
+	/**
+	 * Returns the number of times a byte occurs
+	 */
+	static size_t Count(const void *data, size_t size, std::uint8_t value) noexcept
+	{
+		return Kernels().Count(static_cast<const Byte*>(data), size, value);
+	}
+
+	/**
+	 * Calculates the CRC-32C (Castagnoli) checksum of a block, using the SSE4.2 instruction when available
+	 * @param crc  the checksum of any preceding data, allowing a checksum to be built up in pieces
+	 */
+	static std::uint32_t Crc32c(const void *data, size_t size, std::uint32_t crc = 0) noexcept
+	{
+		auto bytes = static_cast<const Byte*>(data);
+		crc = ~crc;
+
+		crc = (Kernels().HasCrc32 ? Crc32cHardware(bytes, size, crc) : Crc32cScalar(bytes, size, crc));
+		return ~crc;
+	}
+
+	/**
+	 * Indicates if two buffers have the same size and contents
+	 */
+	template<typename T, typename = EnableIfBuffer<T>>
+	static bool Equal(const T &lhs, const T &rhs) noexcept
+	{
+		return lhs.Size() == rhs.Size() && Equal(lhs.Data(), rhs.Data(), lhs.Size());
+	}
+
+	/**
+	 * Returns the offset of the first occurrence of a byte in a buffer
+	 */
+	template<typename T, typename = EnableIfBuffer<T>>
+	static size_t Find(const T &buffer, std::uint8_t value) noexcept
+	{
+		return Find(buffer.Data(), buffer.Size(), value);
+	}
+
+	/**
+	 * Returns the offset of the first occurrence of a sequence of bytes in a buffer
+	 */
+	template<typename T, typename = EnableIfBuffer<T>>
+	static size_t FindPattern(const T &buffer, const void *pattern, size_t patternSize) noexcept
+	{
+		return FindPattern(buffer.Data(), buffer.Size(), pattern, patternSize);
+	}
+
+	/**
+	 * Returns the number of times a byte occurs in a buffer
+	 */
+	template<typename T, typename = EnableIfBuffer<T>>
+	static size_t Count(const T &buffer, std::uint8_t value) noexcept
+	{
+		return Count(buffer.Data(), buffer.Size(), value);
+	}
+
+	/**
+	 * Calculates the CRC-32C checksum of a buffer
+	 */
+	template<typename T, typename = EnableIfBuffer<T>>
+	static std::uint32_t Crc32c(const T &buffer, std::uint32_t crc = 0) noexcept
+	{
+		return Crc32c(buffer.Data(), buffer.Size(), crc);
+	}
+};
+
+} // end of namespace
\ No newline at end of file
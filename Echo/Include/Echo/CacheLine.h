@@ -0,0 +1,14 @@
+#pragma once
+
+#include <cstddef>
+
+namespace Echo
+{
+
+/**
+ * The size of a cache line on the processors we target.
+ * Data written by different threads should be kept this far apart to avoid false sharing
+ */
+const size_t CacheLineSize = 64;
+
+} // end of namespace
\ No newline at end of file
@@ -5,12 +5,17 @@
 #include <Echo\CriticalSection.h>
 #include <Echo\ReadWriteLock.h>
 #include <Echo\WaitHandle.h>
+#include <Echo\AddressWaiter.h>
 
+#include <atomic>
 #include <chrono>
 
 namespace Echo 
 {
 
+template<typename POLICY>
+class PolicyReadWriteLock;
+
 /**
  * Wraps a Win32 conditional variable
  */
@@ -19,6 +24,10 @@ class ConditionalVariable
 private:
 	mutable CONDITION_VARIABLE m_Condition;
 
+	// Locks that aren't built on a CRITICAL_SECTION or SRWLOCK wait on this instead
+	mutable std::atomic<ULONG> m_Generation;
+	mutable std::atomic<ULONG> m_GenerationWaiters;
+
 	bool DoWaitCS(CRITICAL_SECTION *cs, const std::chrono::milliseconds &milliseconds) const
 	{
 		DWORD ms = static_cast<DWORD>(milliseconds.count());
@@ -47,11 +56,63 @@ private:
 		throw WindowsException(_T("wait on conditional variable failed"));
 	}
 
+	/**
+	 * Waits for the generation to move on, releasing the lock whilst we wait.
+	 * We register and read the generation before the lock is released, so a notifier that
+	 * changes state under the lock is guaranteed to see us and a notification can't be lost
+	 */
+	template<typename EXIT, typename ENTER>
+	bool DoWaitGeneration(const std::chrono::milliseconds &milliseconds, EXIT exit, ENTER enter) const
+	{
+		m_GenerationWaiters.fetch_add(1, std::memory_order_seq_cst);
+		ULONG generation = m_Generation.load(std::memory_order_seq_cst);
+
+		exit();
+
+		bool notified = false;
+
+		try
+		{
+			notified = AddressWaiter::Wait(m_Generation, generation, milliseconds);
+		}
+		catch(...)
+		{
+			m_GenerationWaiters.fetch_sub(1, std::memory_order_relaxed);
+			enter();
+			throw;
+		}
+
+		m_GenerationWaiters.fetch_sub(1, std::memory_order_relaxed);
+		enter();
+
+		return notified;
+	}
+
+	/**
+	 * Only does any work when a thread is waiting with a policy lock,
+	 * so notifying a variable used with a CriticalSection or ReadWriteLock costs a single load
+	 */
+	void AdvanceGeneration(bool all) const noexcept
+	{
+		if(m_GenerationWaiters.load(std::memory_order_seq_cst) == 0) return;
+
+		m_Generation.fetch_add(1, std::memory_order_seq_cst);
+
+		if(all)
+		{
+			AddressWaiter::WakeAll(m_Generation);
+		}
+		else
+		{
+			AddressWaiter::WakeOne(m_Generation);
+		}
+	}
+
 public:
 	/**
 	 * Initializes the instance
 	 */
-	ConditionalVariable() noexcept
+	ConditionalVariable() noexcept : m_Generation(0), m_GenerationWaiters(0)
 	{
 		::InitializeConditionVariable(&m_Condition);
 	}
@@ -129,6 +190,49 @@ public:
 		return DoWaitRW(rwLock.Underlying(), duration, CONDITION_VARIABLE_LOCKMODE_SHARED);
 	}
 
+	/**
+	 * Waits forever on the policy read write lock
+	 * @param rwLock  the read-write lock to unlock whilst we wait
+	 */
+	template<typename POLICY>
+	void Wait(PolicyReadWriteLock<POLICY> &rwLock) const
+	{
+		DoWaitGeneration(Infinite, [&]{rwLock.Exit();}, [&]{rwLock.Enter();});
+	}
+
+	/**
+	 * Waits on the condition
+	 * @param rwLock  the read-write lock to unlock whilst we wait
+	 * @param duration  how long to wait for
+	 * @returns true if condition was notified within the duration, otherwise false
+	 */
+	template<typename POLICY>
+	bool Wait(PolicyReadWriteLock<POLICY> &rwLock, const std::chrono::milliseconds &duration) const
+	{
+		return DoWaitGeneration(duration, [&]{rwLock.Exit();}, [&]{rwLock.Enter();});
+	}
+
+	/**
+	 * Waits forever on the shared policy read write lock
+	 * @param rwLock  the read-write lock to unlock whilst we wait
+	 */
+	template<typename POLICY>
+	void WaitShared(PolicyReadWriteLock<POLICY> &rwLock) const
+	{
+		DoWaitGeneration(Infinite, [&]{rwLock.ExitShared();}, [&]{rwLock.EnterShared();});
+	}
+
+	/**
+	 * Waits on the condition
+	 * @param rwLock  the shared read-write lock to unlock whilst we wait
+	 * @param duration  how long to wait for
+	 * @returns true if condition was notified within the duration, otherwise false
+	 */
+	template<typename POLICY>
+	bool WaitShared(PolicyReadWriteLock<POLICY> &rwLock, const std::chrono::milliseconds &duration) const
+	{
+		return DoWaitGeneration(duration, [&]{rwLock.ExitShared();}, [&]{rwLock.EnterShared();});
+	}
 
 	/**
 	 * Notifes the condition, releasing a thread that is waiting on the condition
@@ -136,6 +240,7 @@ public:
 	void Notify() const noexcept
 	{
 		::WakeConditionVariable(&m_Condition);
+		AdvanceGeneration(false);
 	}
 
 	/**
@@ -144,6 +249,7 @@ public:
 	void NotifyAll() const noexcept
 	{
 		::WakeAllConditionVariable(&m_Condition);
+		AdvanceGeneration(true);
 	}
 };
 
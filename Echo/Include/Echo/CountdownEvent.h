@@ -0,0 +1,169 @@
+#pragma once
+
+#include <Echo\WinInclude.h>
+#include <Echo\Exceptions.h>
+#include <Echo\WaitHandle.h>
+#include <Echo\AddressWaiter.h>
+
+#include <atomic>
+#include <chrono>
+
+namespace Echo
+{
+
+/**
+ * An event that is set once its count reaches zero.
+ * Unlike a Latch the count can grow whilst the event is unset, which suits fork-join
+ * code that doesn't know up front how much work it will spawn, and it can be Reset for reuse
+ */
+class CountdownEvent
+{
+private:
+	/**
+	 * Set in m_State whilst threads are parked, so that the count and the need to wake share one word
+	 */
+	static const LONG WaiterFlag = 0x40000000;
+
+	mutable std::atomic<LONG> m_State;
+	const unsigned m_SpinCount;
+
+public:
+	/**
+	 * The default number of pause instructions a Wait spins for before parking
+	 */
+	static const unsigned DefaultSpinCount = 1000;
+
+	/**
+	 * The largest count the event can hold
+	 */
+	static const LONG MaximumCount = WaiterFlag - 1;
+
+	/**
+	 * Initializes the instance
+	 * @param initialCount  the number of signals needed to set the event, up to MaximumCount
+	 * @param spinCount  how many pause instructions to spin for before parking
+	 */
+	explicit CountdownEvent(LONG initialCount, unsigned spinCount = DefaultSpinCount) : m_State(initialCount), m_SpinCount(spinCount)
+	{
+		if(initialCount < 0 || initialCount > MaximumCount) throw ArgumentException(_T("initialCount is out of range"));
+	}
+
+	CountdownEvent(const CountdownEvent&) = delete;
+	CountdownEvent(CountdownEvent&&) = delete;
+
+	CountdownEvent &operator=(const CountdownEvent&) = delete;
+	CountdownEvent &operator=(CountdownEvent&&) = delete;
+
+	/**
+	 * Returns the number of signals still needed to set the event
+	 */
+	LONG CurrentCount() const noexcept
+	{
+		return m_State.load(std::memory_order_acquire) & ~WaiterFlag;
+	}
+
+	/**
+	 * Indicates if the event is set
+	 */
+	bool IsSet() const noexcept
+	{
+		return CurrentCount() == 0;
+	}
+
+	/**
+	 * Signals the event, decrementing the count
+	 * @param count  the number of signals to register
+	 * @returns true if the signals caused the event to be set, otherwise false
+	 */
+	bool Signal(LONG count = 1)
+	{
+		if(count <= 0) throw ArgumentException(_T("count must be greater than zero"));
+
+		LONG current = m_State.load(std::memory_order_relaxed);
+		LONG next = 0;
+
+		do
+		{
+			LONG remaining = current & ~WaiterFlag;
+			if(remaining < count) throw ThreadException(_T("countdown event signalled too many times"));
+
+			// Reaching zero clears the waiter flag too
+			next = (remaining == count ? 0 : current - count);
+		}
+		while(m_State.compare_exchange_weak(current, next, std::memory_order_acq_rel, std::memory_order_relaxed) == false);
+
+		if(next != 0) return false;
+
+		// A waiter may destroy the event as soon as it sees zero, so only the address is used from here on
+		if((current & WaiterFlag) != 0) AddressWaiter::WakeAll(m_State);
+		return true;
+	}
+
+	/**
+	 * Attempts to increment the count
+	 * @param count  the amount to increment by
+	 * @returns true if the count was incremented, false if the event is already set
+	 */
+	bool TryAddCount(LONG count = 1)
+	{
+		if(count <= 0) throw ArgumentException(_T("count must be greater than zero"));
+
+		LONG current = m_State.load(std::memory_order_relaxed);
+
+		do
+		{
+			if(current == 0) return false;
+			if(count > MaximumCount - (current & ~WaiterFlag)) throw ArgumentException(_T("count would exceed MaximumCount"));
+		}
+		while(m_State.compare_exchange_weak(current, current + count, std::memory_order_relaxed) == false);
+
+		return true;
+	}
+
+	/**
+	 * Increments the count. The event must not already be set
+	 * @param count  the amount to increment by
+	 */
+	void AddCount(LONG count = 1)
+	{
+		if(TryAddCount(count) == false) throw ThreadException(_T("countdown event is already set"));
+	}
+
+	/**
+	 * Resets the count.
+	 * Must not be called whilst other threads are using the event
+	 * @param count  the new count
+	 */
+	void Reset(LONG count)
+	{
+		if(count < 0 || count > MaximumCount) throw ArgumentException(_T("count is out of range"));
+
+		// Parked threads stay flagged unless the reset wakes them
+		LONG previous = m_State.load(std::memory_order_relaxed);
+		while(m_State.compare_exchange_weak(previous, (count == 0 ? 0 : count | (previous & WaiterFlag)), std::memory_order_acq_rel, std::memory_order_relaxed) == false)
+		{
+		}
+
+		if(count == 0 && (previous & WaiterFlag) != 0) AddressWaiter::WakeAll(m_State);
+	}
+
+	/**
+	 * Waits forever for the event to be set
+	 */
+	void Wait() const
+	{
+		Wait(Infinite);
+	}
+
+	/**
+	 * Waits for the event to be set
+	 * @param duration  how long to wait for
+	 * @returns true if the event was set, false on timeout
+	 */
+	bool Wait(const std::chrono::milliseconds &duration) const
+	{
+		return AddressWaiter::WaitForZero(m_State, WaiterFlag, m_SpinCount, duration);
+	}
+};
+
+} // end of namespace
\ No newline at end of file
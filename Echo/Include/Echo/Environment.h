@@ -50,6 +50,15 @@ public:
 		return s_SystemInfo.dwPageSize;
 	}
 
+	/**
+	 * Returns the granularity of virtual address reservations and mapped view offsets
+	 */
+	static DWORD AllocationGranularity() noexcept
+	{
+		Initialize();
+		return s_SystemInfo.dwAllocationGranularity;
+	}
+
 	/**
 	 * Returns the name of the machine
 	 */
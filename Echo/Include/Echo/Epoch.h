@@ -0,0 +1,378 @@
+#pragma once
+
+#include <Echo\WinInclude.h>
+#include <Echo\Guard.h>
+#include <Echo\CacheLine.h>
+#include <Echo\CriticalSection.h>
+#include <Echo\IFunctionDispatcher.h>
+#include <Echo\OnDestruct.h>
+
+#include <algorithm>
+#include <atomic>
+#include <vector>
+
+namespace Echo
+{
+
+class EpochParticipant;
+
+/**
+ * Epoch based reclamation, allowing lock-free readers to safely use memory that writers retire.
+ *
+ * Each reading thread registers an EpochParticipant and brackets its reads with Enter/Exit
+ * (or Guard<EpochParticipant>), which just records the global epoch in the participant.
+ * Writers unlink an object and then retire it. A retired object is freed once the global epoch
+ * has advanced twice, which can only happen after every reader that might have seen it has left.
+ *
+ * Readers pay no memory fence. Instead the reclaimer calls FlushProcessWriteBuffers before
+ * looking at the participants, which forces any in-flight reader stores to become visible
+ */
+class EpochManager
+{
+private:
+	friend class EpochParticipant;
+
+	struct Retired
+	{
+		void *Pointer;
+		void (*Deleter)(void*);
+		ULONG64 Epoch;
+	};
+
+	alignas(CacheLineSize) std::atomic<ULONG64> m_Epoch;
+
+	alignas(CacheLineSize) mutable CriticalSection m_SyncRoot;
+	std::vector<EpochParticipant*> m_Participants;
+	std::vector<Retired> m_Retired;
+
+	IFunctionDispatcher *m_Dispatcher;
+	std::atomic<bool> m_ReclaimScheduled;
+	std::atomic<LONG> m_ReclaimsInFlight;
+
+	void Register(EpochParticipant *participant)
+	{
+		Guard<CriticalSection> lock(m_SyncRoot);
+		m_Participants.push_back(participant);
+	}
+
+	void Unregister(EpochParticipant *participant, std::vector<Retired> &retired)
+	{
+		{
+			Guard<CriticalSection> lock(m_SyncRoot);
+
+			m_Participants.erase(std::remove(m_Participants.begin(), m_Participants.end(), participant), m_Participants.end());
+			m_Retired.insert(m_Retired.end(), retired.begin(), retired.end());
+		}
+
+		retired.clear();
+		RequestReclaim();
+	}
+
+	void Accept(std::vector<Retired> &retired)
+	{
+		{
+			Guard<CriticalSection> lock(m_SyncRoot);
+			m_Retired.insert(m_Retired.end(), retired.begin(), retired.end());
+		}
+
+		retired.clear();
+		RequestReclaim();
+	}
+
+	/**
+	 * Reclaims inline, or on the dispatcher if we have one
+	 */
+	void RequestReclaim()
+	{
+		if(m_Dispatcher == nullptr)
+		{
+			Reclaim();
+			return;
+		}
+
+		if(m_ReclaimScheduled.exchange(true, std::memory_order_acq_rel) == false)
+		{
+			// Counted until Reclaim returns, so the destructor can't free anything it's still using.
+			// The flag is cleared first so that retirements made during Reclaim schedule another one
+			m_ReclaimsInFlight.fetch_add(1, std::memory_order_acq_rel);
+
+			try
+			{
+				m_Dispatcher->Submit([this]
+				{
+					OnDestruct done([this]{m_ReclaimsInFlight.fetch_sub(1, std::memory_order_release);});
+
+					m_ReclaimScheduled.store(false, std::memory_order_release);
+					Reclaim();
+				});
+			}
+			catch(...)
+			{
+				m_ReclaimScheduled.store(false, std::memory_order_release);
+				m_ReclaimsInFlight.fetch_sub(1, std::memory_order_release);
+
+				throw;
+			}
+		}
+	}
+
+	static void Free(std::vector<Retired> &retired)
+	{
+		for(auto &item : retired)
+		{
+			item.Deleter(item.Pointer);
+		}
+
+		retired.clear();
+	}
+
+	bool AllParticipantsAt(ULONG64 epoch) const;
+
+public:
+	/**
+	 * Initializes the instance so that reclamation happens on the threads that retire objects
+	 */
+	EpochManager() : m_Epoch(1), m_Dispatcher(nullptr), m_ReclaimScheduled(false), m_ReclaimsInFlight(0)
+	{
+	}
+
+	/**
+	 * Initializes the instance so that reclamation happens in the background
+	 * @param dispatcher  the dispatcher to run reclamation on
+	 */
+	explicit EpochManager(IFunctionDispatcher &dispatcher) : m_Epoch(1), m_Dispatcher(&dispatcher), m_ReclaimScheduled(false), m_ReclaimsInFlight(0)
+	{
+	}
+
+	EpochManager(const EpochManager&) = delete;
+	EpochManager(EpochManager&&) = delete;
+
+	EpochManager &operator=(const EpochManager&) = delete;
+	EpochManager &operator=(EpochManager&&) = delete;
+
+	/**
+	 * Destroys the instance, freeing anything still retired.
+	 * All participants must have been destroyed first
+	 */
+	~EpochManager()
+	{
+		while(m_ReclaimsInFlight.load(std::memory_order_acquire) != 0)
+		{
+			::SwitchToThread();
+		}
+
+		Free(m_Retired);
+	}
+
+	/**
+	 * Returns the current global epoch
+	 */
+	ULONG64 Epoch() const noexcept
+	{
+		return m_Epoch.load(std::memory_order_acquire);
+	}
+
+	/**
+	 * Returns the number of objects waiting to be freed that have been handed to the manager.
+	 * Objects still in a participant's local retire list aren't included
+	 */
+	size_t PendingReclamation() const
+	{
+		Guard<CriticalSection> lock(m_SyncRoot);
+		return m_Retired.size();
+	}
+
+	/**
+	 * Tries to advance the global epoch and frees anything that is no longer reachable.
+	 * Safe to call from any thread, including one that isn't a participant
+	 */
+	void Reclaim()
+	{
+		// Makes every reader's epoch store visible to us without readers paying for a fence
+		::FlushProcessWriteBuffers();
+
+		std::vector<Retired> reclaimable;
+
+		{
+			Guard<CriticalSection> lock(m_SyncRoot);
+
+			ULONG64 epoch = m_Epoch.load(std::memory_order_relaxed);
+
+			if(AllParticipantsAt(epoch))
+			{
+				epoch++;
+				m_Epoch.store(epoch, std::memory_order_seq_cst);
+			}
+
+			auto reachable = std::partition(m_Retired.begin(), m_Retired.end(), [epoch](const Retired &item)
+			{
+				return item.Epoch + 2 > epoch;
+			});
+
+			reclaimable.assign(reachable, m_Retired.end());
+			m_Retired.erase(reachable, m_Retired.end());
+		}
+
+		Free(reclaimable);
+	}
+};
+
+/**
+ * A thread's registration with an EpochManager.
+ * A participant must only be used by the thread that owns it
+ */
+class EpochParticipant
+{
+private:
+	friend class EpochManager;
+
+	// Zero means the thread isn't reading, otherwise it's the epoch the thread entered in
+	alignas(CacheLineSize) std::atomic<ULONG64> m_LocalEpoch;
+	unsigned m_Depth;
+
+	EpochManager &m_Manager;
+	std::vector<EpochManager::Retired> m_RetireList;
+	const size_t m_RetireThreshold;
+
+public:
+	/**
+	 * Initializes the instance, registering it with the manager
+	 * @param manager  the manager to participate in
+	 * @param retireThreshold  how many objects to retire locally before handing them to the manager
+	 */
+	explicit EpochParticipant(EpochManager &manager, size_t retireThreshold = 64) : m_LocalEpoch(0), m_Depth(0), m_Manager(manager), m_RetireThreshold(retireThreshold)
+	{
+		m_RetireList.reserve(retireThreshold);
+		m_Manager.Register(this);
+	}
+
+	EpochParticipant(const EpochParticipant&) = delete;
+	EpochParticipant(EpochParticipant&&) = delete;
+
+	EpochParticipant &operator=(const EpochParticipant&) = delete;
+	EpochParticipant &operator=(EpochParticipant&&) = delete;
+
+	/**
+	 * Destroys the instance, handing any retired objects to the manager
+	 */
+	~EpochParticipant()
+	{
+		m_Manager.Unregister(this, m_RetireList);
+	}
+
+	/**
+	 * Enters a read-side critical section. Critical sections may be nested
+	 */
+	void Enter() noexcept
+	{
+		if(m_Depth++ == 0)
+		{
+			m_LocalEpoch.store(m_Manager.m_Epoch.load(std::memory_order_relaxed), std::memory_order_relaxed);
+			std::atomic_signal_fence(std::memory_order_seq_cst);
+		}
+	}
+
+	/**
+	 * Exits a read-side critical section
+	 */
+	void Exit() noexcept
+	{
+		if(--m_Depth == 0)
+		{
+			std::atomic_signal_fence(std::memory_order_seq_cst);
+			m_LocalEpoch.store(0, std::memory_order_release);
+		}
+	}
+
+	/**
+	 * Indicates if the participant is inside a read-side critical section
+	 */
+	bool InCriticalSection() const noexcept
+	{
+		return m_Depth != 0;
+	}
+
+	/**
+	 * Retires an object that has been unlinked from a shared structure.
+	 * It will be freed once no reader can still be using it
+	 * @param pointer  the object to free
+	 * @param deleter  the function that frees the object
+	 */
+	void Retire(void *pointer, void (*deleter)(void*))
+	{
+		// Order the caller's unlink before we read the epoch we tag the object with
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+
+		ULONG64 epoch = m_Manager.m_Epoch.load(std::memory_order_seq_cst);
+		m_RetireList.push_back({pointer, deleter, epoch});
+
+		if(m_RetireList.size() >= m_RetireThreshold)
+		{
+			m_Manager.Accept(m_RetireList);
+		}
+	}
+
+	/**
+	 * Retires an object that was allocated with new
+	 * @param pointer  the object to delete once no reader can still be using it
+	 */
+	template<typename T>
+	void Retire(T *pointer)
+	{
+		Retire(pointer, [](void *p){delete static_cast<T*>(p);});
+	}
+
+	/**
+	 * Hands any locally retired objects to the manager straight away
+	 */
+	void Flush()
+	{
+		if(m_RetireList.empty() == false) m_Manager.Accept(m_RetireList);
+	}
+};
+
+inline bool EpochManager::AllParticipantsAt(ULONG64 epoch) const
+{
+	for(auto participant : m_Participants)
+	{
+		ULONG64 local = participant->m_LocalEpoch.load(std::memory_order_acquire);
+		if(local != 0 && local != epoch) return false;
+	}
+
+	return true;
+}
+
+/**
+ * A read-side critical section
+ */
+template<>
+class Guard<EpochParticipant>
+{
+private:
+	EpochParticipant &m_Participant;
+
+public:
+	/**
+	 * Initializes the instance by entering a critical section
+	 */
+	explicit Guard(EpochParticipant &participant) noexcept : m_Participant(participant)
+	{
+		m_Participant.Enter();
+	}
+
+	Guard(const Guard &) = delete;
+	Guard &operator=(const Guard &) = delete;
+	Guard &operator=(Guard &&) = delete;
+
+	/**
+	 * Destroys the instance by exitting the critical section
+	 */
+	~Guard() noexcept
+	{
+		m_Participant.Exit();
+	}
+};
+
+using EpochGuard = Guard<EpochParticipant>;
+
+} // end of namespace
\ No newline at end of file
@@ -1,11 +1,14 @@
 #pragma once
 
 #include <utility>
+#include <vector>
 
 #include <Echo\HandleTraits.h>
 #include <Echo\WinInclude.h>
 #include <Echo\Handle.h>
 #include <Echo\Exceptions.h>
+#include <Echo\Environment.h>
+#include <Echo\OnDestruct.h>
 
 #include <Echo\AsyncResult.h>
 #include <Echo\IReaderWriter.h>
@@ -28,6 +31,99 @@ private:
 		}
 	}
 
+	/**
+	 * WriteFileGather and ReadFileScatter transfer exactly one page per element,
+	 * so they can only be used when every segment is a single, page aligned page
+	 * @returns true if the segments qualify, with elements holding the null terminated segment array
+	 */
+	template<typename SEGMENT>
+	static bool TryMakePageElements(const SEGMENT *segments, size_t count, std::vector<FILE_SEGMENT_ELEMENT> &elements)
+	{
+		const DWORD pageSize = Environment::PageSize();
+		if(count == 0 || count > MAXDWORD / pageSize) return false;
+
+		for(size_t i = 0; i < count; i++)
+		{
+			if(segments[i].Size != pageSize || reinterpret_cast<ULONG_PTR>(segments[i].Data) % pageSize != 0) return false;
+		}
+
+		elements.resize(count + 1);
+
+		for(size_t i = 0; i < count; i++)
+		{
+			elements[i].Alignment = reinterpret_cast<ULONG_PTR>(segments[i].Data);
+		}
+
+		return true;
+	}
+
+	/**
+	 * Waits for a single segment started by ReadFile or WriteFile.
+	 * Reaching the end of the file counts as transferring nothing rather than as an error
+	 * @returns the number of bytes transferred
+	 */
+	DWORD CompleteSegment(BOOL success, OVERLAPPED &overlapped, const TCHAR *message)
+	{
+		if(!success)
+		{
+			DWORD error = ::GetLastError();
+
+			if(error == ERROR_HANDLE_EOF) return 0;
+			if(error != ERROR_IO_PENDING) throw IOException(message);
+		}
+
+		DWORD bytesTransferred = 0;
+
+		if(!::GetOverlappedResult(UnderlyingHandle(), &overlapped, &bytesTransferred, TRUE))
+		{
+			if(::GetLastError() == ERROR_HANDLE_EOF) return 0;
+			throw IOException(message);
+		}
+
+		return bytesTransferred;
+	}
+
+	/**
+	 * Transfers the segments one at a time at consecutive offsets, waiting for each to finish
+	 * and stopping at the first short transfer. The overlapped structure is left describing the
+	 * whole transfer as complete, and its offset is restored even if a segment fails
+	 */
+	template<typename SEGMENT, typename OPERATION>
+	AsyncResult TransferSegments(const SEGMENT *segments, size_t count, OVERLAPPED &overlapped, OPERATION operation)
+	{
+		const DWORD start = overlapped.Offset;
+		const DWORD startHigh = overlapped.OffsetHigh;
+
+		OnDestruct restore([&]
+		{
+			overlapped.Offset = start;
+			overlapped.OffsetHigh = startHigh;
+		});
+
+		const DWORD64 position = (static_cast<DWORD64>(startHigh) << 32) | start;
+		DWORD bytesTransferred = 0;
+
+		for(size_t i = 0; i < count; i++)
+		{
+			if(segments[i].Size == 0) continue;
+			if(segments[i].Data == nullptr) throw ArgumentNullException(_T("segments"));
+
+			DWORD64 segmentPosition = position + bytesTransferred;
+			overlapped.Offset = static_cast<DWORD>(segmentPosition);
+			overlapped.OffsetHigh = static_cast<DWORD>(segmentPosition >> 32);
+
+			DWORD transferred = operation(segments[i], overlapped);
+			bytesTransferred += transferred;
+
+			if(transferred != segments[i].Size) break;
+		}
+
+		overlapped.Internal = 0;
+		overlapped.InternalHigh = bytesTransferred;
+
+		return AsyncResult::Complete;
+	}
+
 protected:
 	File(HANDLE handle) : Handle(handle)
 	{
@@ -240,6 +336,133 @@ public:
 		return bytesTransferred;
 	}
 
+	/**
+	 * Writes several buffers with a single WriteFileGather call, if they qualify.
+	 * The file must have been opened with FILE_FLAG_NO_BUFFERING and every segment must be one page aligned page
+	 * @param segments  the buffers to write
+	 * @param count  the number of segments
+	 * @param overlapped  an overlapped structure describing the async operation
+	 * @param result  receives Complete if the write completed immediately, Pending if it is pending completion
+	 * @returns true if the write was issued, false if the segments or the file don't allow it, in which case nothing was written
+	 */
+	bool TryWriteFileGather(const ConstIoSegment *segments, size_t count, OVERLAPPED &overlapped, AsyncResult &result)
+	{
+		if(segments == nullptr && count != 0) throw ArgumentNullException(_T("segments"));
+		CheckHandle();
+
+		std::vector<FILE_SEGMENT_ELEMENT> elements;
+		if(!TryMakePageElements(segments, count, elements)) return false;
+
+		DWORD bytesToWrite = static_cast<DWORD>(count) * Environment::PageSize();
+		auto success = ::WriteFileGather(UnderlyingHandle(), elements.data(), bytesToWrite, nullptr, &overlapped);
+
+		if(success)
+		{
+			result = AsyncResult::Complete;
+			return true;
+		}
+
+		if(::GetLastError() == ERROR_IO_PENDING)
+		{
+			result = AsyncResult::Pending;
+			return true;
+		}
+
+		// The file wasn't opened for unbuffered I/O
+		if(::GetLastError() == ERROR_INVALID_PARAMETER) return false;
+
+		throw IOException(_T("WriteFileGather failed"));
+	}
+
+	/**
+	 * Reads into several buffers with a single ReadFileScatter call, if they qualify.
+	 * The file must have been opened with FILE_FLAG_NO_BUFFERING and every segment must be one page aligned page
+	 * @param segments  the buffers to read into
+	 * @param count  the number of segments
+	 * @param overlapped  an overlapped structure describing the async operation
+	 * @param result  receives Complete if the read completed immediately, Pending if it is pending completion
+	 * @returns true if the read was issued, false if the segments or the file don't allow it, in which case nothing was read
+	 */
+	bool TryReadFileScatter(const IoSegment *segments, size_t count, OVERLAPPED &overlapped, AsyncResult &result)
+	{
+		if(segments == nullptr && count != 0) throw ArgumentNullException(_T("segments"));
+		CheckHandle();
+
+		std::vector<FILE_SEGMENT_ELEMENT> elements;
+		if(!TryMakePageElements(segments, count, elements)) return false;
+
+		DWORD bytesToRead = static_cast<DWORD>(count) * Environment::PageSize();
+		auto success = ::ReadFileScatter(UnderlyingHandle(), elements.data(), bytesToRead, nullptr, &overlapped);
+
+		if(success)
+		{
+			result = AsyncResult::Complete;
+			return true;
+		}
+
+		if(::GetLastError() == ERROR_IO_PENDING)
+		{
+			result = AsyncResult::Pending;
+			return true;
+		}
+
+		if(::GetLastError() == ERROR_HANDLE_EOF)
+		{
+			overlapped.Internal = 0;
+			overlapped.InternalHigh = 0;
+
+			result = AsyncResult::Complete;
+			return true;
+		}
+
+		// The file wasn't opened for unbuffered I/O
+		if(::GetLastError() == ERROR_INVALID_PARAMETER) return false;
+
+		throw IOException(_T("ReadFileScatter failed"));
+	}
+
+	/**
+	 * Asynchronously writes several buffers to consecutive positions in the file.
+	 * When TryWriteFileGather can be used this is a single WriteFileGather call.
+	 * Otherwise the segments are written one after another and the operation has completed when this returns
+	 * @param segments  the buffers to write
+	 * @param count  the number of segments
+	 * @param overlapped  an overlapped structure describing the async operation
+	 * @returns Complete if the write completed immediately, Pending if the write is pending completion
+	 */
+	virtual AsyncResult WriteVAsync(const ConstIoSegment *segments, size_t count, OVERLAPPED &overlapped) override
+	{
+		AsyncResult result = AsyncResult::Complete;
+		if(TryWriteFileGather(segments, count, overlapped, result)) return result;
+
+		return TransferSegments(segments, count, overlapped, [this](const ConstIoSegment &segment, OVERLAPPED &segmentOverlapped)
+		{
+			auto success = ::WriteFile(UnderlyingHandle(), segment.Data, segment.Size, nullptr, &segmentOverlapped);
+			return CompleteSegment(success, segmentOverlapped, _T("WriteVAsync failed"));
+		});
+	}
+
+	/**
+	 * Asynchronously reads consecutive positions in the file into several buffers.
+	 * When TryReadFileScatter can be used this is a single ReadFileScatter call.
+	 * Otherwise the segments are read one after another and the operation has completed when this returns
+	 * @param segments  the buffers to read into
+	 * @param count  the number of segments
+	 * @param overlapped  an overlapped structure describing the async operation
+	 * @returns Complete if the read completed immediately, Pending if the read is pending completion
+	 */
+	virtual AsyncResult ReadVAsync(const IoSegment *segments, size_t count, OVERLAPPED &overlapped) override
+	{
+		AsyncResult result = AsyncResult::Complete;
+		if(TryReadFileScatter(segments, count, overlapped, result)) return result;
+
+		return TransferSegments(segments, count, overlapped, [this](const IoSegment &segment, OVERLAPPED &segmentOverlapped)
+		{
+			auto success = ::ReadFile(UnderlyingHandle(), segment.Data, segment.Size, nullptr, &segmentOverlapped);
+			return CompleteSegment(success, segmentOverlapped, _T("ReadVAsync failed"));
+		});
+	}
+
 	/**
 	 * Sets the handle to an invalid value and returns the OS value
 	 * @returns the OS handle
@@ -3,10 +3,29 @@
 #include <Echo\WinInclude.h>
 
 #include <Echo\AsyncResult.h>
+#include <Echo\Exceptions.h>
 
 namespace Echo 
 {
 
+/**
+ * A buffer to read into as part of a scatter read
+ */
+struct IoSegment
+{
+	void *Data;
+	DWORD Size;
+};
+
+/**
+ * A buffer to write from as part of a gather write
+ */
+struct ConstIoSegment
+{
+	const void *Data;
+	DWORD Size;
+};
+
 /**
  * Defines the behaviour for a source that can be read or written to
  */
@@ -63,6 +82,86 @@ public:
 	 * @returns the number of bytes transferred by the async operation
 	 */
 	virtual DWORD WaitForAsyncToComplete(OVERLAPPED &overlapped) = 0;
+
+	/**
+	 * Synchronously writes several buffers, one after the other.
+	 * By default each segment is written in turn, stopping at the first short write
+	 * @param segments  the buffers to write
+	 * @param count  the number of segments
+	 * @returns the total number of bytes written
+	 */
+	virtual DWORD WriteV(const ConstIoSegment *segments, size_t count)
+	{
+		if(segments == nullptr && count != 0) throw ArgumentNullException(_T("segments"));
+
+		DWORD bytesWritten = 0;
+
+		for(size_t i = 0; i < count; i++)
+		{
+			DWORD written = Write(segments[i].Data, segments[i].Size);
+			bytesWritten += written;
+
+			if(written != segments[i].Size) break;
+		}
+
+		return bytesWritten;
+	}
+
+	/**
+	 * Asynchronously writes several buffers, one after the other.
+	 * By default this calls WriteV and completes immediately
+	 * @param segments  the buffers to write
+	 * @param count  the number of segments
+	 * @param overlapped  an overlapped structure describing the async operation
+	 * @returns Complete if the write completed immediately, Pending if the write is pending completion
+	 */
+	virtual AsyncResult WriteVAsync(const ConstIoSegment *segments, size_t count, OVERLAPPED &overlapped)
+	{
+		overlapped.InternalHigh = WriteV(segments, count);
+		overlapped.Internal = 0;
+
+		return AsyncResult::Complete;
+	}
+
+	/**
+	 * Synchronously reads into several buffers, filling each before moving to the next.
+	 * By default each segment is read in turn, stopping at the first short read
+	 * @param segments  the buffers to read into
+	 * @param count  the number of segments
+	 * @returns the total number of bytes read
+	 */
+	virtual DWORD ReadV(const IoSegment *segments, size_t count)
+	{
+		if(segments == nullptr && count != 0) throw ArgumentNullException(_T("segments"));
+
+		DWORD bytesRead = 0;
+
+		for(size_t i = 0; i < count; i++)
+		{
+			DWORD read = Read(segments[i].Data, segments[i].Size);
+			bytesRead += read;
+
+			if(read != segments[i].Size) break;
+		}
+
+		return bytesRead;
+	}
+
+	/**
+	 * Asynchronously reads into several buffers, filling each before moving to the next.
+	 * By default this calls ReadV and completes immediately
+	 * @param segments  the buffers to read into
+	 * @param count  the number of segments
+	 * @param overlapped  an overlapped structure describing the async operation
+	 * @returns Complete if the read completed immediately, Pending if the read is pending completion
+	 */
+	virtual AsyncResult ReadVAsync(const IoSegment *segments, size_t count, OVERLAPPED &overlapped)
+	{
+		overlapped.InternalHigh = ReadV(segments, count);
+		overlapped.Internal = 0;
+
+		return AsyncResult::Complete;
+	}
 };
 
 } // end of namespace
\ No newline at end of file
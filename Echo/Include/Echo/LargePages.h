@@ -0,0 +1,103 @@
+#pragma once
+
+#include <Echo\WinInclude.h>
+
+#include <mutex>
+
+namespace Echo
+{
+
+/**
+ * The kind of pages backing a piece of memory
+ */
+enum class PageMode
+{
+	Standard,
+	Large
+};
+
+/**
+ * Support for large page allocations, which cut TLB misses for big, randomly accessed data.
+ *
+ * Large pages need the "Lock pages in memory" privilege (SeLockMemoryPrivilege) to be granted
+ * to the account. The first call into the class tries to enable it for the process.
+ * Allocations that ask for large pages fall back to standard pages when they're unavailable
+ */
+class LargePages final
+{
+private:
+	static std::once_flag s_InitFlag;
+	static SIZE_T s_MinimumSize;
+	static bool s_Available;
+
+	static bool EnablePrivilege() noexcept
+	{
+		HANDLE token = nullptr;
+		if(!::OpenProcessToken(::GetCurrentProcess(), TOKEN_ADJUST_PRIVILEGES | TOKEN_QUERY, &token)) return false;
+
+		TOKEN_PRIVILEGES privileges = {};
+		privileges.PrivilegeCount = 1;
+		privileges.Privileges[0].Attributes = SE_PRIVILEGE_ENABLED;
+
+		bool enabled = false;
+
+		if(::LookupPrivilegeValue(nullptr, SE_LOCK_MEMORY_NAME, &privileges.Privileges[0].Luid))
+		{
+			// AdjustTokenPrivileges succeeds even when the account doesn't hold the privilege
+			enabled = ::AdjustTokenPrivileges(token, FALSE, &privileges, 0, nullptr, nullptr) && ::GetLastError() != ERROR_NOT_ALL_ASSIGNED;
+		}
+
+		::CloseHandle(token);
+		return enabled;
+	}
+
+	static void Initialize()
+	{
+		std::call_once(s_InitFlag, []
+		{
+			s_MinimumSize = ::GetLargePageMinimum();
+			s_Available = (s_MinimumSize != 0 && EnablePrivilege());
+		});
+	}
+
+public:
+	LargePages() = delete;
+	LargePages(const LargePages&) = delete;
+	LargePages &operator=(const LargePages&) = delete;
+
+	/**
+	 * Indicates if the process can allocate large pages
+	 */
+	static bool IsAvailable()
+	{
+		Initialize();
+		return s_Available;
+	}
+
+	/**
+	 * Returns the size of a large page, or zero if the processor doesn't support them.
+	 * Large page allocations must be a multiple of this size
+	 */
+	static SIZE_T MinimumSize()
+	{
+		Initialize();
+		return s_MinimumSize;
+	}
+
+	/**
+	 * Rounds a size up to a whole number of large pages
+	 */
+	static SIZE_T RoundUp(SIZE_T size)
+	{
+		SIZE_T pageSize = MinimumSize();
+		if(pageSize == 0) return size;
+
+		return ((size + pageSize - 1) / pageSize) * pageSize;
+	}
+};
+
+__declspec(selectany) std::once_flag LargePages::s_InitFlag;
+__declspec(selectany) SIZE_T LargePages::s_MinimumSize = 0;
+__declspec(selectany) bool LargePages::s_Available = false;
+
+} // end of namespace
\ No newline at end of file
@@ -0,0 +1,128 @@
+#pragma once
+
+#include <Echo\WinInclude.h>
+#include <Echo\Exceptions.h>
+#include <Echo\WaitHandle.h>
+#include <Echo\AddressWaiter.h>
+
+#include <atomic>
+#include <chrono>
+
+namespace Echo
+{
+
+/**
+ * A single use countdown that releases every waiter once it reaches zero.
+ * Counting down and waiting stay in user space unless a thread actually has to park
+ */
+class Latch
+{
+private:
+	/**
+	 * Set in m_State whilst threads are parked, so that the count and the need to wake share one word
+	 */
+	static const LONG WaiterFlag = 0x40000000;
+
+	mutable std::atomic<LONG> m_State;
+	const unsigned m_SpinCount;
+
+public:
+	/**
+	 * The default number of pause instructions a Wait spins for before parking
+	 */
+	static const unsigned DefaultSpinCount = 1000;
+
+	/**
+	 * The largest count the latch can hold
+	 */
+	static const LONG MaximumCount = WaiterFlag - 1;
+
+	/**
+	 * Initializes the instance
+	 * @param count  the number of count downs needed to open the latch, up to MaximumCount
+	 * @param spinCount  how many pause instructions to spin for before parking
+	 */
+	explicit Latch(LONG count, unsigned spinCount = DefaultSpinCount) : m_State(count), m_SpinCount(spinCount)
+	{
+		if(count < 0 || count > MaximumCount) throw ArgumentException(_T("count is out of range"));
+	}
+
+	Latch(const Latch&) = delete;
+	Latch(Latch&&) = delete;
+
+	Latch &operator=(const Latch&) = delete;
+	Latch &operator=(Latch&&) = delete;
+
+	/**
+	 * Returns the number of count downs still needed to open the latch
+	 */
+	LONG Count() const noexcept
+	{
+		return m_State.load(std::memory_order_acquire) & ~WaiterFlag;
+	}
+
+	/**
+	 * Indicates if the latch has opened
+	 */
+	bool IsSet() const noexcept
+	{
+		return Count() == 0;
+	}
+
+	/**
+	 * Decrements the count, releasing the waiters if it reaches zero
+	 * @param count  the amount to decrement by
+	 */
+	void CountDown(LONG count = 1)
+	{
+		if(count <= 0) throw ArgumentException(_T("count must be greater than zero"));
+
+		LONG current = m_State.load(std::memory_order_relaxed);
+		LONG next = 0;
+
+		do
+		{
+			LONG remaining = current & ~WaiterFlag;
+			if(remaining < count) throw ThreadException(_T("latch counted down too many times"));
+
+			// Reaching zero clears the waiter flag too
+			next = (remaining == count ? 0 : current - count);
+		}
+		while(m_State.compare_exchange_weak(current, next, std::memory_order_acq_rel, std::memory_order_relaxed) == false);
+
+		// A waiter may destroy the latch as soon as it sees zero, so only the address is used from here on
+		if(next == 0 && (current & WaiterFlag) != 0)
+		{
+			AddressWaiter::WakeAll(m_State);
+		}
+	}
+
+	/**
+	 * Decrements the count and then waits for the latch to open
+	 */
+	void ArriveAndWait()
+	{
+		CountDown();
+		Wait();
+	}
+
+	/**
+	 * Waits forever for the latch to open
+	 */
+	void Wait() const
+	{
+		Wait(Infinite);
+	}
+
+	/**
+	 * Waits for the latch to open
+	 * @param duration  how long to wait for
+	 * @returns true if the latch opened, false on timeout
+	 */
+	bool Wait(const std::chrono::milliseconds &duration) const
+	{
+		return AddressWaiter::WaitForZero(m_State, WaiterFlag, m_SpinCount, duration);
+	}
+};
+
+} // end of namespace
\ No newline at end of file
@@ -0,0 +1,227 @@
+#pragma once
+
+#include <Echo\WinInclude.h>
+#include <Echo\Events.h>
+#include <Echo\WaitHandle.h>
+#include <Echo\SpinWait.h>
+#include <Echo\AddressWaiter.h>
+
+#include <atomic>
+#include <chrono>
+
+namespace Echo
+{
+
+/**
+ * Base class for the user-space events.
+ * The event lives in a single atomic word holding the signalled bit and a count of
+ * parked waiters, so Set only calls into the kernel when someone is actually parked
+ * and Wait spins briefly before parking with WaitOnAddress.
+ *
+ * Unlike Event there is no handle, so a light event can't be used with MultiWaiter
+ */
+class LightEvent
+{
+private:
+	enum : LONG
+	{
+		Signalled = 1,
+		OneWaiter = 2
+	};
+
+	mutable std::atomic<LONG> m_State;
+	const bool m_IsManual;
+	const unsigned m_SpinCount;
+
+	static bool IsSignalled(LONG state) noexcept
+	{
+		return (state & Signalled) != 0;
+	}
+
+	static bool HasWaiters(LONG state) noexcept
+	{
+		return state >= OneWaiter;
+	}
+
+	/**
+	 * Checks the signal, consuming it for an auto reset event
+	 */
+	bool TryConsume() const noexcept
+	{
+		LONG state = m_State.load(std::memory_order_acquire);
+
+		while(IsSignalled(state))
+		{
+			if(m_IsManual) return true;
+			if(m_State.compare_exchange_weak(state, state & ~Signalled, std::memory_order_acquire, std::memory_order_relaxed)) return true;
+		}
+
+		return false;
+	}
+
+	bool DoWait(const std::chrono::milliseconds &duration) const
+	{
+		if(TryConsume()) return true;
+		if(duration.count() == 0) return false;
+
+		SpinWait spinner;
+		while(spinner.TotalPauses() < m_SpinCount)
+		{
+			spinner.SpinOnce();
+			if(TryConsume()) return true;
+		}
+
+		const bool infinite = (duration == Infinite);
+		const auto deadline = std::chrono::steady_clock::now() + duration;
+
+		for(;;)
+		{
+			LONG state = m_State.load(std::memory_order_acquire);
+
+			if(IsSignalled(state))
+			{
+				if(TryConsume()) return true;
+				continue;
+			}
+
+			// Register as a waiter, but only if the event is still unsignalled
+			const LONG waiting = state + OneWaiter;
+			if(m_State.compare_exchange_weak(state, waiting, std::memory_order_acq_rel, std::memory_order_relaxed) == false) continue;
+
+			auto remaining = std::chrono::milliseconds(INFINITE);
+			if(!infinite)
+			{
+				auto left = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now());
+				remaining = (left.count() > 0 ? left : std::chrono::milliseconds(0));
+			}
+
+			bool woken = false;
+
+			try
+			{
+				woken = AddressWaiter::Wait(m_State, waiting, remaining);
+			}
+			catch(...)
+			{
+				m_State.fetch_sub(OneWaiter, std::memory_order_relaxed);
+				throw;
+			}
+
+			m_State.fetch_sub(OneWaiter, std::memory_order_relaxed);
+
+			// One last look, so a signal that arrived as we timed out isn't left behind
+			if(woken == false) return TryConsume();
+		}
+	}
+
+protected:
+	/**
+	 * Initializes the instance
+	 * @param isManual  true for a manual reset event, false for an auto reset event
+	 * @param initialState  the initial state for the event
+	 * @param spinCount  how many pause instructions to spin for before parking
+	 */
+	LightEvent(bool isManual, InitialState initialState, unsigned spinCount) noexcept : m_State(initialState == InitialState::Signalled ? Signalled : 0), m_IsManual(isManual), m_SpinCount(spinCount)
+	{
+	}
+
+public:
+	/**
+	 * The default number of pause instructions a Wait spins for before parking
+	 */
+	static const unsigned DefaultSpinCount = 1000;
+
+	LightEvent(const LightEvent&) = delete;
+	LightEvent(LightEvent&&) = delete;
+
+	LightEvent &operator=(const LightEvent&) = delete;
+	LightEvent &operator=(LightEvent&&) = delete;
+
+	/**
+	 * Sets the event.
+	 * A manual reset event releases every waiter, an auto reset event releases one
+	 */
+	void Set() const noexcept
+	{
+		LONG previous = m_State.fetch_or(Signalled, std::memory_order_release);
+
+		if(IsSignalled(previous) || HasWaiters(previous) == false) return;
+
+		if(m_IsManual)
+		{
+			AddressWaiter::WakeAll(m_State);
+		}
+		else
+		{
+			AddressWaiter::WakeOne(m_State);
+		}
+	}
+
+	/**
+	 * Resets the event
+	 */
+	void Reset() const noexcept
+	{
+		m_State.fetch_and(~Signalled, std::memory_order_relaxed);
+	}
+
+	/**
+	 * Indicates if the event is currently signalled
+	 */
+	bool IsSet() const noexcept
+	{
+		return IsSignalled(m_State.load(std::memory_order_acquire));
+	}
+
+	/**
+	 * Waits forever for the event to be signalled
+	 */
+	void Wait() const
+	{
+		DoWait(Infinite);
+	}
+
+	/**
+	 * Waits for the event to be signalled
+	 * @param duration  how long to wait for
+	 * @returns true if the event was signalled, false on timeout
+	 */
+	bool Wait(const std::chrono::milliseconds &duration) const
+	{
+		return DoWait(duration);
+	}
+};
+
+/**
+ * A user-space manual reset event
+ */
+class ManualResetLightEvent final : public LightEvent
+{
+public:
+	/**
+	 * Initializes the instance
+	 * @param initialState  the initial state of the event
+	 * @param spinCount  how many pause instructions to spin for before parking
+	 */
+	explicit ManualResetLightEvent(InitialState initialState, unsigned spinCount = DefaultSpinCount) noexcept : LightEvent(true, initialState, spinCount)
+	{
+	}
+};
+
+/**
+ * A user-space auto reset event
+ */
+class AutoResetLightEvent final : public LightEvent
+{
+public:
+	/**
+	 * Initializes the instance
+	 * @param initialState  the initial state of the event
+	 * @param spinCount  how many pause instructions to spin for before parking
+	 */
+	explicit AutoResetLightEvent(InitialState initialState, unsigned spinCount = DefaultSpinCount) noexcept : LightEvent(false, initialState, spinCount)
+	{
+	}
+};
+
+} // end of namespace
\ No newline at end of file
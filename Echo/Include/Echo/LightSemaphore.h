@@ -0,0 +1,293 @@
+#pragma once
+
+#include <Echo\WinInclude.h>
+#include <Echo\Guard.h>
+#include <Echo\Exceptions.h>
+#include <Echo\WaitHandle.h>
+#include <Echo\SpinWait.h>
+#include <Echo\AddressWaiter.h>
+
+#include <atomic>
+#include <chrono>
+#include <utility>
+
+namespace Echo
+{
+
+/**
+ * A counting semaphore that lives in user space.
+ * The permit count is an atomic, so acquiring an available permit or releasing
+ * when nobody is parked never leaves user mode. Threads that can't get their permits
+ * spin briefly and then park with WaitOnAddress.
+ *
+ * Permits may be acquired in batches. There is no queueing, so a thread asking for a
+ * large batch can be overtaken by threads asking for smaller ones
+ */
+class LightSemaphore
+{
+private:
+	std::atomic<LONG> m_Count;
+	std::atomic<LONG> m_Waiters;
+	const LONG m_MaximumCount;
+	const unsigned m_SpinCount;
+
+	bool TryTake(LONG count) noexcept
+	{
+		LONG available = m_Count.load(std::memory_order_relaxed);
+
+		while(available >= count)
+		{
+			if(m_Count.compare_exchange_weak(available, available - count, std::memory_order_acquire, std::memory_order_relaxed)) return true;
+		}
+
+		return false;
+	}
+
+	void ValidateCount(LONG count) const
+	{
+		if(count <= 0) throw ArgumentException(_T("count must be greater than zero"));
+		if(count > m_MaximumCount) throw ArgumentException(_T("count exceeds the maximum count of the semaphore"));
+	}
+
+	bool DoAcquire(LONG count, const std::chrono::milliseconds &duration)
+	{
+		ValidateCount(count);
+
+		if(TryTake(count)) return true;
+		if(duration.count() == 0) return false;
+
+		SpinWait spinner;
+		while(spinner.TotalPauses() < m_SpinCount)
+		{
+			spinner.SpinOnce();
+			if(m_Count.load(std::memory_order_relaxed) >= count && TryTake(count)) return true;
+		}
+
+		const bool infinite = (duration == Infinite);
+		const auto deadline = std::chrono::steady_clock::now() + duration;
+
+		for(;;)
+		{
+			// Advertise ourselves before the final check so a releaser either sees us or we see its permits
+			m_Waiters.fetch_add(1, std::memory_order_seq_cst);
+			LONG available = m_Count.load(std::memory_order_seq_cst);
+
+			bool woken = true;
+
+			if(available < count)
+			{
+				auto remaining = std::chrono::milliseconds(INFINITE);
+				if(!infinite)
+				{
+					auto left = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now());
+					remaining = (left.count() > 0 ? left : std::chrono::milliseconds(0));
+				}
+
+				try
+				{
+					woken = AddressWaiter::Wait(m_Count, available, remaining);
+				}
+				catch(...)
+				{
+					m_Waiters.fetch_sub(1, std::memory_order_relaxed);
+					throw;
+				}
+			}
+
+			m_Waiters.fetch_sub(1, std::memory_order_relaxed);
+
+			if(TryTake(count)) return true;
+			if(woken == false) return false;
+		}
+	}
+
+public:
+	/**
+	 * The default number of pause instructions an Acquire spins for before parking
+	 */
+	static const unsigned DefaultSpinCount = 1000;
+
+	/**
+	 * Initializes the instance
+	 * @param count  the initial and maximum count for the semaphore
+	 */
+	explicit LightSemaphore(LONG count) : LightSemaphore(count, count)
+	{
+	}
+
+	/**
+	 * Initializes the instance
+	 * @param initialCount  the initial count of the semaphore. Must be less than or equal to maximumCount
+	 * @param maximumCount  the maximum count for the semaphore. Must be greater than zero
+	 * @param spinCount  how many pause instructions to spin for before parking
+	 */
+	LightSemaphore(LONG initialCount, LONG maximumCount, unsigned spinCount = DefaultSpinCount) : m_Count(initialCount), m_Waiters(0), m_MaximumCount(maximumCount), m_SpinCount(spinCount)
+	{
+		if(maximumCount <= 0) throw ArgumentException(_T("maximumCount must be greater than zero"));
+		if(initialCount < 0 || initialCount > maximumCount) throw ArgumentException(_T("initialCount must be between zero and maximumCount"));
+	}
+
+	LightSemaphore(const LightSemaphore&) = delete;
+	LightSemaphore(LightSemaphore&&) = delete;
+
+	LightSemaphore &operator=(const LightSemaphore&) = delete;
+	LightSemaphore &operator=(LightSemaphore&&) = delete;
+
+	/**
+	 * Returns the number of permits currently available
+	 */
+	LONG Count() const noexcept
+	{
+		return m_Count.load(std::memory_order_relaxed);
+	}
+
+	/**
+	 * Returns the maximum count for the semaphore
+	 */
+	LONG MaximumCount() const noexcept
+	{
+		return m_MaximumCount;
+	}
+
+	/**
+	 * Waits forever to acquire permits
+	 * @param count  the number of permits to acquire
+	 */
+	void Acquire(LONG count = 1)
+	{
+		DoAcquire(count, Infinite);
+	}
+
+	/**
+	 * Waits to acquire permits
+	 * @param count  the number of permits to acquire
+	 * @param duration  how long to wait for
+	 * @returns true if the permits were acquired, false on timeout
+	 */
+	bool Acquire(LONG count, const std::chrono::milliseconds &duration)
+	{
+		return DoAcquire(count, duration);
+	}
+
+	/**
+	 * Attempts to acquire permits without waiting
+	 * @param count  the number of permits to acquire
+	 * @returns true if the permits were acquired, otherwise false
+	 */
+	bool TryAcquire(LONG count = 1)
+	{
+		ValidateCount(count);
+		return TryTake(count);
+	}
+
+	/**
+	 * Returns permits to the semaphore, waking parked threads if there are any
+	 * @param count  the number of permits to release
+	 * @returns the previous count of the semaphore
+	 */
+	LONG Release(LONG count = 1)
+	{
+		if(count <= 0) throw ArgumentException(_T("count must be greater than zero"));
+
+		LONG previous = m_Count.load(std::memory_order_relaxed);
+
+		do
+		{
+			if(previous > m_MaximumCount - count) throw ThreadException(_T("could not release semaphore"));
+		}
+		while(m_Count.compare_exchange_weak(previous, previous + count, std::memory_order_seq_cst, std::memory_order_relaxed) == false);
+
+		// Waiters may want different batch sizes, so wake them all and let them recheck
+		if(m_Waiters.load(std::memory_order_seq_cst) != 0)
+		{
+			AddressWaiter::WakeAll(m_Count);
+		}
+
+		return previous;
+	}
+};
+
+/**
+ * Acquires permits from a light semaphore
+ */
+template<>
+class Guard<LightSemaphore>
+{
+private:
+	LightSemaphore &m_Semaphore;
+	const LONG m_Count;
+
+public:
+	/**
+	 * Initializes the instance by acquiring permits
+	 * @param semaphore  the semaphore to acquire from
+	 * @param count  the number of permits to acquire
+	 */
+	explicit Guard(LightSemaphore &semaphore, LONG count = 1) : m_Semaphore(semaphore), m_Count(count)
+	{
+		m_Semaphore.Acquire(m_Count);
+	}
+
+	Guard(const Guard &) = delete;
+	Guard &operator=(const Guard &) = delete;
+	Guard &operator=(Guard &&) = delete;
+
+	/**
+	 * Destroys the instance by releasing the permits
+	 */
+	~Guard()
+	{
+		m_Semaphore.Release(m_Count);
+	}
+};
+
+template<>
+class UniqueGuard<LightSemaphore>
+{
+private:
+	LightSemaphore *m_Semaphore;
+	LONG m_Count;
+
+public:
+	/**
+	 * Initializes the instance by acquiring permits
+	 * @param semaphore  the semaphore to acquire from
+	 * @param count  the number of permits to acquire
+	 */
+	explicit UniqueGuard(LightSemaphore &semaphore, LONG count = 1) : m_Semaphore(&semaphore), m_Count(count)
+	{
+		m_Semaphore->Acquire(m_Count);
+	}
+
+	UniqueGuard(UniqueGuard &&rhs) : m_Semaphore(nullptr), m_Count(0)
+	{
+		std::swap(m_Semaphore, rhs.m_Semaphore);
+		std::swap(m_Count, rhs.m_Count);
+	}
+
+	UniqueGuard(const UniqueGuard &) = delete;
+
+	UniqueGuard &operator=(UniqueGuard &&rhs) noexcept
+	{
+		if(this != &rhs)
+		{
+			std::swap(m_Semaphore, rhs.m_Semaphore);
+			std::swap(m_Count, rhs.m_Count);
+		}
+
+		return *this;
+	}
+
+	/**
+	 * Destroys the instance by releasing the permits
+	 */
+	~UniqueGuard()
+	{
+		if(m_Semaphore) m_Semaphore->Release(m_Count);
+	}
+};
+
+using LightSemaphoreGuard = Guard<LightSemaphore>;
+using LightSemaphoreUniqueGuard = UniqueGuard<LightSemaphore>;
+
+} // end of namespace
\ No newline at end of file
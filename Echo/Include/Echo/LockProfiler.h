@@ -0,0 +1,644 @@
+#pragma once
+
+#include <Echo\WinInclude.h>
+#include <Echo\tstring.h>
+#include <Echo\Exceptions.h>
+#include <Echo\Guard.h>
+#include <Echo\CriticalSection.h>
+#include <Echo\ReadWriteLock.h>
+#include <Echo\Mutex.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <utility>
+#include <vector>
+
+namespace Echo
+{
+
+/**
+ * The aggregated statistics for a lock site
+ */
+struct LockSiteReport
+{
+	tstd::tstring Name;
+
+	ULONG64 Acquisitions = 0;
+	ULONG64 ContendedAcquisitions = 0;
+
+	std::chrono::nanoseconds TotalWait{0};
+	std::chrono::nanoseconds MaxWait{0};
+
+	std::chrono::nanoseconds TotalHold{0};
+	std::chrono::nanoseconds MaxHold{0};
+};
+
+/**
+ * Collects lock statistics.
+ * Each thread records into its own table, so recording never contends.
+ * A snapshot sums the tables of the live threads and of every thread that has exited
+ */
+class LockProfiler final
+{
+public:
+	/**
+	 * The most lock sites that can be profiled
+	 */
+	static const size_t MaximumSites = 256;
+
+private:
+	friend class LockSite;
+	template<typename LOCK> friend class ProfiledLock;
+
+	/**
+	 * The counters for one site on one thread.
+	 * Only the owning thread writes, so updates are plain stores rather than interlocked operations
+	 */
+	class SiteCounters
+	{
+	private:
+		std::atomic<ULONG64> m_Acquisitions{0};
+		std::atomic<ULONG64> m_ContendedAcquisitions{0};
+		std::atomic<ULONG64> m_TotalWait{0};
+		std::atomic<ULONG64> m_MaxWait{0};
+		std::atomic<ULONG64> m_TotalHold{0};
+		std::atomic<ULONG64> m_MaxHold{0};
+
+		static void Add(std::atomic<ULONG64> &counter, ULONG64 value) noexcept
+		{
+			counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+		}
+
+		static void Max(std::atomic<ULONG64> &counter, ULONG64 value) noexcept
+		{
+			if(value > counter.load(std::memory_order_relaxed)) counter.store(value, std::memory_order_relaxed);
+		}
+
+	public:
+		void RecordAcquire(bool contended, ULONG64 waitTicks) noexcept
+		{
+			Add(m_Acquisitions, 1);
+
+			if(contended)
+			{
+				Add(m_ContendedAcquisitions, 1);
+				Add(m_TotalWait, waitTicks);
+				Max(m_MaxWait, waitTicks);
+			}
+		}
+
+		void RecordHold(ULONG64 holdTicks) noexcept
+		{
+			Add(m_TotalHold, holdTicks);
+			Max(m_MaxHold, holdTicks);
+		}
+
+		void MergeInto(SiteCounters &target) const noexcept
+		{
+			Add(target.m_Acquisitions, m_Acquisitions.load(std::memory_order_relaxed));
+			Add(target.m_ContendedAcquisitions, m_ContendedAcquisitions.load(std::memory_order_relaxed));
+			Add(target.m_TotalWait, m_TotalWait.load(std::memory_order_relaxed));
+			Max(target.m_MaxWait, m_MaxWait.load(std::memory_order_relaxed));
+			Add(target.m_TotalHold, m_TotalHold.load(std::memory_order_relaxed));
+			Max(target.m_MaxHold, m_MaxHold.load(std::memory_order_relaxed));
+		}
+
+		void MergeInto(LockSiteReport &report, double nanosecondsPerTick) const
+		{
+			auto toNanoseconds = [nanosecondsPerTick](const std::atomic<ULONG64> &ticks)
+			{
+				return std::chrono::nanoseconds(static_cast<long long>(ticks.load(std::memory_order_relaxed) * nanosecondsPerTick));
+			};
+
+			report.Acquisitions += m_Acquisitions.load(std::memory_order_relaxed);
+			report.ContendedAcquisitions += m_ContendedAcquisitions.load(std::memory_order_relaxed);
+			report.TotalWait += toNanoseconds(m_TotalWait);
+			report.MaxWait = std::max(report.MaxWait, toNanoseconds(m_MaxWait));
+			report.TotalHold += toNanoseconds(m_TotalHold);
+			report.MaxHold = std::max(report.MaxHold, toNanoseconds(m_MaxHold));
+		}
+	};
+
+	class ThreadTable
+	{
+	public:
+		SiteCounters Sites[MaximumSites];
+	};
+
+	class Registry
+	{
+	public:
+		CriticalSection SyncRoot;
+		std::vector<tstd::tstring> SiteNames;
+		std::vector<ThreadTable*> LiveThreads;
+		ThreadTable RetiredThreads;
+	};
+
+	/**
+	 * Registers the calling thread's table on first use and retires it when the thread exits
+	 */
+	class ThreadRegistration
+	{
+	private:
+		ThreadTable m_Table;
+
+	public:
+		ThreadRegistration()
+		{
+			auto &registry = GetRegistry();
+
+			Guard<CriticalSection> lock(registry.SyncRoot);
+			registry.LiveThreads.push_back(&m_Table);
+		}
+
+		~ThreadRegistration()
+		{
+			auto &registry = GetRegistry();
+
+			Guard<CriticalSection> lock(registry.SyncRoot);
+			auto &threads = registry.LiveThreads;
+			threads.erase(std::remove(threads.begin(), threads.end(), &m_Table), threads.end());
+
+			for(size_t i = 0; i < MaximumSites; i++)
+			{
+				m_Table.Sites[i].MergeInto(registry.RetiredThreads.Sites[i]);
+			}
+		}
+
+		ThreadRegistration(const ThreadRegistration&) = delete;
+		ThreadRegistration &operator=(const ThreadRegistration&) = delete;
+
+		ThreadTable &Table() noexcept
+		{
+			return m_Table;
+		}
+	};
+
+	static Registry &GetRegistry()
+	{
+		static Registry registry;
+		return registry;
+	}
+
+	static SiteCounters &CurrentThreadCounters(size_t siteIndex)
+	{
+		static thread_local ThreadRegistration registration;
+		return registration.Table().Sites[siteIndex];
+	}
+
+	static size_t RegisterSite(const tstd::tstring &name)
+	{
+		auto &registry = GetRegistry();
+
+		Guard<CriticalSection> lock(registry.SyncRoot);
+		if(registry.SiteNames.size() == MaximumSites) throw Exception(_T("too many lock sites"));
+
+		registry.SiteNames.push_back(name);
+		return registry.SiteNames.size() - 1;
+	}
+
+	static LONGLONG Now() noexcept
+	{
+		LARGE_INTEGER now;
+		::QueryPerformanceCounter(&now);
+
+		return now.QuadPart;
+	}
+
+public:
+	LockProfiler() = delete;
+	LockProfiler(const LockProfiler&) = delete;
+	LockProfiler &operator=(const LockProfiler&) = delete;
+
+	/**
+	 * Returns the statistics for every registered lock site
+	 */
+	static std::vector<LockSiteReport> Snapshot()
+	{
+		LARGE_INTEGER frequency;
+		::QueryPerformanceFrequency(&frequency);
+		const double nanosecondsPerTick = 1e9 / static_cast<double>(frequency.QuadPart);
+
+		auto &registry = GetRegistry();
+		Guard<CriticalSection> lock(registry.SyncRoot);
+
+		std::vector<LockSiteReport> reports(registry.SiteNames.size());
+
+		for(size_t i = 0; i < reports.size(); i++)
+		{
+			auto &report = reports[i];
+			report.Name = registry.SiteNames[i];
+
+			registry.RetiredThreads.Sites[i].MergeInto(report, nanosecondsPerTick);
+
+			for(auto table : registry.LiveThreads)
+			{
+				table->Sites[i].MergeInto(report, nanosecondsPerTick);
+			}
+		}
+
+		return reports;
+	}
+
+	/**
+	 * Returns the statistics for every registered lock site as text, hottest sites first
+	 */
+	static tstd::tstring Dump()
+	{
+		auto reports = Snapshot();
+
+		std::sort(reports.begin(), reports.end(), [](const LockSiteReport &lhs, const LockSiteReport &rhs)
+		{
+			return lhs.TotalWait > rhs.TotalWait;
+		});
+
+		tstd::tostringstream stream;
+
+		for(const auto &report : reports)
+		{
+			stream	<< report.Name
+					<< _T(": acquisitions=") << report.Acquisitions
+					<< _T(" contended=") << report.ContendedAcquisitions
+					<< _T(" totalWaitNs=") << report.TotalWait.count()
+					<< _T(" maxWaitNs=") << report.MaxWait.count()
+					<< _T(" totalHoldNs=") << report.TotalHold.count()
+					<< _T(" maxHoldNs=") << report.MaxHold.count()
+					<< std::endl;
+		}
+
+		return stream.str();
+	}
+};
+
+/**
+ * Identifies a place in the code whose locks are profiled.
+ * Sites are intended to be long lived, typically static, and may be shared by many locks
+ */
+class LockSite
+{
+private:
+	const size_t m_Index;
+
+public:
+	/**
+	 * Initializes the instance
+	 * @param name  the name the site is reported under
+	 */
+	explicit LockSite(const tstd::tstring &name) : m_Index(LockProfiler::RegisterSite(name))
+	{
+	}
+
+	LockSite(const LockSite&) = delete;
+	LockSite &operator=(const LockSite&) = delete;
+
+	/**
+	 * Returns the index of the site within the profiler
+	 */
+	size_t Index() const noexcept
+	{
+		return m_Index;
+	}
+};
+
+/**
+ * Adapts the different lock apis so that ProfiledLock can treat them the same way
+ */
+template<typename LOCK>
+class ProfiledLockTraits
+{
+};
+
+template<>
+class ProfiledLockTraits<CriticalSection>
+{
+public:
+	static bool TryAcquire(CriticalSection &lock)	{return lock.TryEnter();}
+	static void Acquire(CriticalSection &lock)		{lock.Enter();}
+	static void Release(CriticalSection &lock)		{lock.Exit();}
+};
+
+template<>
+class ProfiledLockTraits<ReadWriteLock>
+{
+public:
+	static bool TryAcquire(ReadWriteLock &lock)		{return lock.TryEnter();}
+	static void Acquire(ReadWriteLock &lock)		{lock.Enter();}
+	static void Release(ReadWriteLock &lock)		{lock.Exit();}
+};
+
+template<>
+class ProfiledLockTraits<Mutex>
+{
+public:
+	static bool TryAcquire(Mutex &lock)				{return lock.Wait(std::chrono::milliseconds(0));}
+	static void Acquire(Mutex &lock)				{lock.Wait();}
+	static void Release(Mutex &lock)				{lock.Release();}
+};
+
+/**
+ * Wraps a CriticalSection, ReadWriteLock or Mutex and records how it is used against a LockSite.
+ * An acquisition is counted as contended if it could not be taken immediately.
+ * Hold times are recorded for exclusive acquisitions
+ */
+template<typename LOCK>
+class ProfiledLock
+{
+private:
+	typedef ProfiledLockTraits<LOCK> Traits;
+
+	LOCK m_Lock;
+	const LockSite &m_Site;
+
+	// Only touched by the thread holding the lock exclusively. CriticalSection and Mutex are recursive
+	LONGLONG m_AcquiredAt = 0;
+	unsigned m_Depth = 0;
+
+	LockProfiler::SiteCounters &Counters() const
+	{
+		return LockProfiler::CurrentThreadCounters(m_Site.Index());
+	}
+
+	void Acquired(bool contended, LONGLONG waitStart)
+	{
+		LONGLONG now = (contended || m_Depth == 0 ? LockProfiler::Now() : 0);
+		Counters().RecordAcquire(contended, static_cast<ULONG64>(now - waitStart));
+
+		if(m_Depth++ == 0) m_AcquiredAt = now;
+	}
+
+public:
+	/**
+	 * Initializes the instance
+	 * @param site  the site to record statistics against
+	 * @param args  any arguments required to construct the underlying lock
+	 */
+	template<typename... ARGS>
+	explicit ProfiledLock(const LockSite &site, ARGS&&... args) : m_Lock(std::forward<ARGS>(args)...), m_Site(site)
+	{
+	}
+
+	ProfiledLock(const ProfiledLock&) = delete;
+	ProfiledLock &operator=(const ProfiledLock&) = delete;
+
+	/**
+	 * Acquires the lock exclusively
+	 */
+	void Enter()
+	{
+		if(Traits::TryAcquire(m_Lock))
+		{
+			Acquired(false, 0);
+			return;
+		}
+
+		LONGLONG waitStart = LockProfiler::Now();
+		Traits::Acquire(m_Lock);
+		Acquired(true, waitStart);
+	}
+
+	/**
+	 * Attempts to acquire the lock exclusively without waiting
+	 * @returns true if the lock was acquired, otherwise false
+	 */
+	bool TryEnter()
+	{
+		if(Traits::TryAcquire(m_Lock) == false) return false;
+
+		Acquired(false, 0);
+		return true;
+	}
+
+	/**
+	 * Releases an exclusive acquisition
+	 */
+	void Exit()
+	{
+		if(--m_Depth == 0)
+		{
+			Counters().RecordHold(static_cast<ULONG64>(LockProfiler::Now() - m_AcquiredAt));
+		}
+
+		Traits::Release(m_Lock);
+	}
+
+	/**
+	 * Acquires a ReadWriteLock in shared mode
+	 */
+	void EnterShared()
+	{
+		if(m_Lock.TryEnterShared())
+		{
+			Counters().RecordAcquire(false, 0);
+			return;
+		}
+
+		LONGLONG waitStart = LockProfiler::Now();
+		m_Lock.EnterShared();
+		Counters().RecordAcquire(true, static_cast<ULONG64>(LockProfiler::Now() - waitStart));
+	}
+
+	/**
+	 * Releases a shared acquisition of a ReadWriteLock
+	 */
+	void ExitShared()
+	{
+		m_Lock.ExitShared();
+	}
+
+	/**
+	 * Returns the underlying lock, for example to wait on a ConditionalVariable.
+	 * Anything done directly to the underlying lock isn't profiled
+	 */
+	LOCK &Inner() noexcept
+	{
+		return m_Lock;
+	}
+
+	/**
+	 * Returns the site the lock records against
+	 */
+	const LockSite &Site() const noexcept
+	{
+		return m_Site;
+	}
+};
+
+/**
+ * Locks a profiled lock
+ */
+template<typename LOCK>
+class Guard<ProfiledLock<LOCK>>
+{
+private:
+	ProfiledLock<LOCK> &m_Lock;
+
+public:
+	/**
+	 * Initializes the instance by acquiring the lock
+	 */
+	explicit Guard(ProfiledLock<LOCK> &lock) : m_Lock(lock)
+	{
+		m_Lock.Enter();
+	}
+
+	Guard(const Guard &) = delete;
+	Guard &operator=(const Guard &) = delete;
+	Guard &operator=(Guard &&) = delete;
+
+	/**
+	 * Destroys the instance by releasing the lock
+	 */
+	~Guard()
+	{
+		m_Lock.Exit();
+	}
+};
+
+/**
+ * Unlocks a profiled lock
+ */
+template<typename LOCK>
+class Unguard<ProfiledLock<LOCK>>
+{
+private:
+	ProfiledLock<LOCK> &m_Lock;
+
+public:
+	/**
+	 * Initializes the instance by releasing the lock
+	 */
+	Unguard(ProfiledLock<LOCK> &lock) : m_Lock(lock)
+	{
+		m_Lock.Exit();
+	}
+
+	Unguard(const Unguard &) = delete;
+	Unguard &operator=(const Unguard &) = delete;
+	Unguard &operator=(Unguard &&) = delete;
+
+	/**
+	 * Destroys the instance by reacquiring the lock
+	 */
+	~Unguard()
+	{
+		m_Lock.Enter();
+	}
+};
+
+template<typename LOCK>
+class TryGuard<ProfiledLock<LOCK>>
+{
+private:
+	ProfiledLock<LOCK> &m_Lock;
+	const bool m_Locked;
+
+public:
+	/**
+	 * Initializes the instance by attempting to acquire the lock
+	 */
+	TryGuard(ProfiledLock<LOCK> &lock) : m_Lock(lock), m_Locked(lock.TryEnter())
+	{
+	}
+
+	TryGuard(const TryGuard &) = delete;
+	TryGuard &operator=(const TryGuard &) = delete;
+	TryGuard &operator=(TryGuard &&) = delete;
+
+	/**
+	 * Inidicates if the lock was acquired
+	 */
+	bool IsLocked() const
+	{
+		return m_Locked;
+	}
+
+	/**
+	 * Destroys the instance releasing the lock if it was acquired
+	 */
+	~TryGuard()
+	{
+		if(m_Locked)
+		{
+			m_Lock.Exit();
+		}
+	}
+};
+
+template<typename LOCK>
+class UniqueGuard<ProfiledLock<LOCK>>
+{
+private:
+	ProfiledLock<LOCK> *m_Lock;
+
+public:
+	/**
+	 * Initializes the instance by acquiring the lock
+	 */
+	explicit UniqueGuard(ProfiledLock<LOCK> &lock) : m_Lock(&lock)
+	{
+		m_Lock->Enter();
+	}
+
+	UniqueGuard(UniqueGuard &&rhs) : m_Lock(nullptr)
+	{
+		std::swap(m_Lock, rhs.m_Lock);
+	}
+
+	UniqueGuard(const UniqueGuard &) = delete;
+
+	UniqueGuard &operator=(UniqueGuard &&rhs) noexcept
+	{
+		if(this != &rhs)
+		{
+			std::swap(m_Lock, rhs.m_Lock);
+		}
+
+		return *this;
+	}
+
+	/**
+	 * Destroys the instance by releasing the lock
+	 */
+	~UniqueGuard()
+	{
+		if(m_Lock) m_Lock->Exit();
+	}
+};
+
+/**
+ * Locks a profiled read write lock in shared mode
+ */
+template<typename LOCK>
+class ProfiledLockSharedGuard
+{
+private:
+	ProfiledLock<LOCK> &m_Lock;
+
+public:
+	/**
+	 * Initializes the instance by acquiring the lock in shared mode
+	 */
+	explicit ProfiledLockSharedGuard(ProfiledLock<LOCK> &lock) : m_Lock(lock)
+	{
+		m_Lock.EnterShared();
+	}
+
+	ProfiledLockSharedGuard(const ProfiledLockSharedGuard &) = delete;
+	ProfiledLockSharedGuard &operator=(const ProfiledLockSharedGuard &) = delete;
+	ProfiledLockSharedGuard &operator=(ProfiledLockSharedGuard &&) = delete;
+
+	/**
+	 * Destroys the instance by releasing the shared lock
+	 */
+	~ProfiledLockSharedGuard()
+	{
+		m_Lock.ExitShared();
+	}
+};
+
+using ProfiledCriticalSection = ProfiledLock<CriticalSection>;
+using ProfiledReadWriteLock = ProfiledLock<ReadWriteLock>;
+using ProfiledMutex = ProfiledLock<Mutex>;
+
+} // end of namespace
\ No newline at end of file
@@ -8,6 +8,12 @@
 #include <Echo\tstring.h>
 
 #include <Echo\File.h>
+#include <Echo\LargePages.h>
+
+// Only declared from the 10.0.15063 SDK onwards, and the projects target an earlier one
+#ifndef FILE_MAP_LARGE_PAGES
+#define FILE_MAP_LARGE_PAGES 0x20000000
+#endif
 
 namespace Echo 
 {
@@ -20,11 +26,13 @@ class MemoryMappedFile : public Handle
 private:
 	typedef HandleNull Traits;
 
+	PageMode m_Pages = PageMode::Standard;
+
 protected:
 	/**
 	 * Initializes the instance from an existing handle
 	 */
-	MemoryMappedFile(HANDLE handle) : Handle(handle)
+	MemoryMappedFile(HANDLE handle, PageMode pages = PageMode::Standard) : Handle(handle), m_Pages(pages)
 	{
 	}
 
@@ -51,6 +59,7 @@ public:
 	MemoryMappedFile(MemoryMappedFile &&rhs) : Handle(Traits::InvalidValue())
 	{
 		Swap(rhs);
+		std::swap(m_Pages, rhs.m_Pages);
 	}
 
 	MemoryMappedFile(const MemoryMappedFile&) = delete;
@@ -64,6 +73,7 @@ public:
 		if(this != &rhs)
 		{
 			Swap(rhs);
+			std::swap(m_Pages, rhs.m_Pages);
 			rhs.Close();
 		}
 
@@ -90,6 +100,14 @@ public:
 		return handle;
 	}
 
+	/**
+	 * Returns the kind of pages backing the mapping
+	 */
+	PageMode Pages() const noexcept
+	{
+		return m_Pages;
+	}
+
 	void Flush(const void *address, SIZE_T bytesToFlush=0) const
 	{
 		auto success = ::FlushViewOfFile(address,bytesToFlush);
@@ -97,7 +115,8 @@ public:
 	}
 
 	/**
-	 * Maps a portion of the memory mapped file into memory
+	 * Maps a portion of the memory mapped file into memory.
+	 * For a large page mapping the offset and size must be multiples of LargePages::MinimumSize
 	 * @params offset  the offset into the file to map
 	 * @params bytesToMap  how many bytes to map into view
 	 * @params desiredAccess  the access required (eg FILE_MAP_READ or FILE_MAP_WRITE)
@@ -108,6 +127,8 @@ public:
 		DWORD low = static_cast<DWORD>(offset);
 		DWORD high = static_cast<DWORD>(offset>>32);
 
+		if(m_Pages == PageMode::Large) desiredAccess |= FILE_MAP_LARGE_PAGES;
+
 		void *address = ::MapViewOfFile(UnderlyingHandle(), desiredAccess, high, low, bytesToMap);
 		if(address == nullptr) throw IOException(_T("Map failed"));
 
@@ -179,6 +200,34 @@ public:
 		return MemoryMappedFile(mappingHandle);
 	}
 
+	/**
+	 * Creates a memory mapped file that is backed by the system paging file, using large pages if requested and available.
+	 * If large pages can't be used the mapping falls back to standard pages; Pages() reports which was used.
+	 * A large page mapping is committed up front and its size is rounded up to a whole number of large pages
+	 * @param mappingSize  how big the in memory file should be
+	 * @param protection  the page protection required (eq PAGE_READONLY, PAGE_READWRITE)
+	 * @param pages  the kind of pages wanted
+	 * @param optionalMappingName  a name that can be used to open the same memory mapped file in another process
+	 * @returns a MemoryMappedFile instance
+	 */
+	static MemoryMappedFile InMemory(DWORD64 mappingSize, DWORD protection, PageMode pages, const tstd::tstring &optionalMappingName=_T(""))
+	{
+		if(pages == PageMode::Large && LargePages::IsAvailable())
+		{
+			DWORD64 size = LargePages::RoundUp(static_cast<SIZE_T>(mappingSize));
+			DWORD low = static_cast<DWORD>(size);
+			DWORD high = static_cast<DWORD>(size >> 32);
+
+			const TCHAR *mappingName = nullptr;
+			if(optionalMappingName.length() != 0) mappingName = optionalMappingName.c_str();
+
+			auto mappingHandle = ::CreateFileMapping(INVALID_HANDLE_VALUE, nullptr, protection | SEC_COMMIT | SEC_LARGE_PAGES, high, low, mappingName);
+			if(mappingHandle != Traits::InvalidValue()) return MemoryMappedFile(mappingHandle, PageMode::Large);
+		}
+
+		return InMemory(mappingSize, protection, optionalMappingName);
+	}
+
 	/**
 	 * Opens an existing file mapping
 	 * @param mappingName  the name of the file mapping
@@ -0,0 +1,347 @@
+#pragma once
+
+#include <Echo\WinInclude.h>
+#include <Echo\Exceptions.h>
+#include <Echo\Environment.h>
+#include <Echo\MemoryMappedFile.h>
+#include <Echo\IReaderWriter.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+// The placeholder flags are only declared from the 10.0.17134 SDK onwards, and the projects target an earlier one
+#ifndef MEM_RESERVE_PLACEHOLDER
+#define MEM_RESERVE_PLACEHOLDER 0x00040000
+#endif
+
+#ifndef MEM_REPLACE_PLACEHOLDER
+#define MEM_REPLACE_PLACEHOLDER 0x00004000
+#endif
+
+#ifndef MEM_PRESERVE_PLACEHOLDER
+#define MEM_PRESERVE_PLACEHOLDER 0x00000002
+#endif
+
+namespace Echo
+{
+
+/**
+ * A ring buffer of bytes whose storage is mapped into memory twice, back to back.
+ *
+ * Writing past the end of the first mapping lands at the start of the ring, so the
+ * readable bytes and the free space are always contiguous, however they wrap.
+ * Parsers can work on a record that straddles the end of the ring in place, and
+ * ReadRegion/WriteRegion can be handed straight to File reads and writes.
+ *
+ * The capacity is rounded up to the allocation granularity (usually 64KB).
+ * The class isn't thread safe
+ */
+class MirroredRingBuffer
+{
+private:
+	typedef PVOID (WINAPI *VirtualAlloc2Function)(HANDLE, PVOID, SIZE_T, ULONG, ULONG, void*, ULONG);
+	typedef PVOID (WINAPI *MapViewOfFile3Function)(HANDLE, HANDLE, PVOID, ULONG64, SIZE_T, ULONG, ULONG, void*, ULONG);
+
+	/**
+	 * How many times to try to map the views when placeholders aren't available,
+	 * as another thread can take the address range between probing and mapping it
+	 */
+	static const int MapAttempts = 16;
+
+	size_t m_Capacity;
+	MemoryMappedFile m_Section;
+	std::uint8_t *m_Data;
+	size_t m_ReadOffset;
+	size_t m_Size;
+
+	static size_t RoundUp(size_t size) noexcept
+	{
+		const size_t granularity = Environment::AllocationGranularity();
+		if(size == 0) size = 1;
+
+		return ((size + granularity - 1) / granularity) * granularity;
+	}
+
+	static void ThrowPreservingError(const TCHAR *message, DWORD error)
+	{
+		::SetLastError(error);
+		throw WindowsException(message);
+	}
+
+	/**
+	 * Maps the views into halves of a placeholder reservation, so no other allocation can slip in between them.
+	 * @returns the address of the first view, or null if VirtualAlloc2 and MapViewOfFile3 aren't available (before Windows 10 1803)
+	 */
+	static std::uint8_t *MapWithPlaceholders(HANDLE section, size_t size)
+	{
+		HMODULE kernel = ::GetModuleHandle(_T("kernelbase.dll"));
+		if(kernel == nullptr) return nullptr;
+
+		auto virtualAlloc2 = reinterpret_cast<VirtualAlloc2Function>(::GetProcAddress(kernel, "VirtualAlloc2"));
+		auto mapViewOfFile3 = reinterpret_cast<MapViewOfFile3Function>(::GetProcAddress(kernel, "MapViewOfFile3"));
+		if(virtualAlloc2 == nullptr || mapViewOfFile3 == nullptr) return nullptr;
+
+		auto placeholder = static_cast<std::uint8_t*>(virtualAlloc2(nullptr, nullptr, size * 2, MEM_RESERVE | MEM_RESERVE_PLACEHOLDER, PAGE_NOACCESS, nullptr, 0));
+		if(placeholder == nullptr) throw WindowsException(_T("could not reserve the ring buffer address space"));
+
+		// Split the reservation into two placeholders, one for each view
+		if(!::VirtualFree(placeholder, size, MEM_RELEASE | MEM_PRESERVE_PLACEHOLDER))
+		{
+			DWORD error = ::GetLastError();
+			::VirtualFree(placeholder, 0, MEM_RELEASE);
+
+			ThrowPreservingError(_T("could not split the ring buffer address space"), error);
+		}
+
+		auto process = ::GetCurrentProcess();
+
+		if(mapViewOfFile3(section, process, placeholder, 0, size, MEM_REPLACE_PLACEHOLDER, PAGE_READWRITE, nullptr, 0) == nullptr)
+		{
+			DWORD error = ::GetLastError();
+			::VirtualFree(placeholder, 0, MEM_RELEASE);
+			::VirtualFree(placeholder + size, 0, MEM_RELEASE);
+
+			ThrowPreservingError(_T("could not map the ring buffer"), error);
+		}
+
+		if(mapViewOfFile3(section, process, placeholder + size, 0, size, MEM_REPLACE_PLACEHOLDER, PAGE_READWRITE, nullptr, 0) == nullptr)
+		{
+			DWORD error = ::GetLastError();
+			::UnmapViewOfFile(placeholder);
+			::VirtualFree(placeholder + size, 0, MEM_RELEASE);
+
+			ThrowPreservingError(_T("could not map the ring buffer mirror"), error);
+		}
+
+		return placeholder;
+	}
+
+	/**
+	 * Finds a free range by reserving and releasing it, then maps the views into it.
+	 * Another thread can grab the range in between, so this retries a few times
+	 */
+	static std::uint8_t *MapWithRetry(HANDLE section, size_t size)
+	{
+		for(int attempt = 0; attempt < MapAttempts; attempt++)
+		{
+			auto address = static_cast<std::uint8_t*>(::VirtualAlloc(nullptr, size * 2, MEM_RESERVE, PAGE_NOACCESS));
+			if(address == nullptr) throw WindowsException(_T("could not reserve the ring buffer address space"));
+
+			::VirtualFree(address, 0, MEM_RELEASE);
+
+			if(::MapViewOfFileEx(section, FILE_MAP_WRITE, 0, 0, size, address) == nullptr) continue;
+
+			if(::MapViewOfFileEx(section, FILE_MAP_WRITE, 0, 0, size, address + size) != nullptr) return address;
+
+			::UnmapViewOfFile(address);
+		}
+
+		throw WindowsException(_T("could not map the ring buffer"));
+	}
+
+	std::uint8_t *WriteAddress() const noexcept
+	{
+		size_t offset = m_ReadOffset + m_Size;
+		if(offset >= m_Capacity) offset -= m_Capacity;
+
+		return m_Data + offset;
+	}
+
+public:
+	/**
+	 * Initializes the instance
+	 * @param minimumCapacity  the number of bytes the ring must be able to hold.
+	 *        This is rounded up to the allocation granularity
+	 */
+	explicit MirroredRingBuffer(size_t minimumCapacity) : m_Capacity(RoundUp(minimumCapacity)), m_Section(MemoryMappedFile::InMemory(m_Capacity, PAGE_READWRITE)), m_Data(nullptr), m_ReadOffset(0), m_Size(0)
+	{
+		m_Data = MapWithPlaceholders(m_Section.UnderlyingHandle(), m_Capacity);
+		if(m_Data == nullptr) m_Data = MapWithRetry(m_Section.UnderlyingHandle(), m_Capacity);
+	}
+
+	MirroredRingBuffer(const MirroredRingBuffer&) = delete;
+	MirroredRingBuffer(MirroredRingBuffer&&) = delete;
+	MirroredRingBuffer &operator=(const MirroredRingBuffer&) = delete;
+	MirroredRingBuffer &operator=(MirroredRingBuffer&&) = delete;
+
+	/**
+	 * Destroys the instance by unmapping both views
+	 */
+	~MirroredRingBuffer()
+	{
+		::UnmapViewOfFile(m_Data + m_Capacity);
+		::UnmapViewOfFile(m_Data);
+	}
+
+	/**
+	 * Returns the number of bytes the ring can hold
+	 */
+	size_t Capacity() const noexcept
+	{
+		return m_Capacity;
+	}
+
+	/**
+	 * Returns the number of bytes waiting to be read
+	 */
+	size_t Size() const noexcept
+	{
+		return m_Size;
+	}
+
+	/**
+	 * Returns the number of bytes that can be written before the ring is full
+	 */
+	size_t Free() const noexcept
+	{
+		return m_Capacity - m_Size;
+	}
+
+	/**
+	 * Indicates if there is nothing to read
+	 */
+	bool IsEmpty() const noexcept
+	{
+		return m_Size == 0;
+	}
+
+	/**
+	 * Indicates if there is no room to write
+	 */
+	bool IsFull() const noexcept
+	{
+		return m_Size == m_Capacity;
+	}
+
+	/**
+	 * Returns the bytes waiting to be read, which are always contiguous. There are Size() of them
+	 */
+	const void *ReadRegion() const noexcept
+	{
+		return m_Data + m_ReadOffset;
+	}
+
+	/**
+	 * Returns the bytes waiting to be read as a specified type
+	 */
+	template<typename T>
+	const T *ReadRegionAs() const noexcept
+	{
+		return reinterpret_cast<const T*>(m_Data + m_ReadOffset);
+	}
+
+	/**
+	 * Discards bytes from the front of the ring once they have been processed
+	 * @param bytes  the number of bytes, which must not be more than Size()
+	 */
+	void Consume(size_t bytes)
+	{
+		if(bytes > m_Size) throw ArgumentException(_T("bytes is more than is in the ring buffer"));
+
+		m_ReadOffset += bytes;
+		if(m_ReadOffset >= m_Capacity) m_ReadOffset -= m_Capacity;
+
+		m_Size -= bytes;
+		if(m_Size == 0) m_ReadOffset = 0;
+	}
+
+	/**
+	 * Returns the free space in the ring, which is always contiguous. There are Free() bytes of it
+	 */
+	void *WriteRegion() noexcept
+	{
+		return WriteAddress();
+	}
+
+	/**
+	 * Adds bytes written into WriteRegion to the readable data
+	 * @param bytes  the number of bytes written, which must not be more than Free()
+	 */
+	void Commit(size_t bytes)
+	{
+		if(bytes > Free()) throw ArgumentException(_T("bytes is more than the free space in the ring buffer"));
+		m_Size += bytes;
+	}
+
+	/**
+	 * Empties the ring
+	 */
+	void Clear() noexcept
+	{
+		m_ReadOffset = 0;
+		m_Size = 0;
+	}
+
+	/**
+	 * Copies bytes into the ring
+	 * @param data  the bytes to write
+	 * @param bytes  the maximum number of bytes to write
+	 * @returns the number of bytes written, which is less than requested if the ring fills up
+	 */
+	size_t Write(const void *data, size_t bytes)
+	{
+		bytes = (std::min)(bytes, Free());
+		if(bytes == 0) return 0;
+
+		if(data == nullptr) throw ArgumentNullException(_T("data"));
+
+		::memcpy(WriteAddress(), data, bytes);
+		m_Size += bytes;
+
+		return bytes;
+	}
+
+	/**
+	 * Copies bytes out of the ring, consuming them
+	 * @param data  where to copy the bytes to
+	 * @param bytes  the maximum number of bytes to read
+	 * @returns the number of bytes read
+	 */
+	size_t Read(void *data, size_t bytes)
+	{
+		bytes = (std::min)(bytes, m_Size);
+		if(bytes == 0) return 0;
+
+		if(data == nullptr) throw ArgumentNullException(_T("data"));
+
+		::memcpy(data, ReadRegion(), bytes);
+		Consume(bytes);
+
+		return bytes;
+	}
+
+	/**
+	 * Reads from a source straight into the free space of the ring
+	 * @param source  the file or other source to read from
+	 * @returns the number of bytes read, which is zero at the end of the source or if the ring is full
+	 */
+	DWORD FillFrom(IReaderWriter &source)
+	{
+		DWORD bytesToRead = static_cast<DWORD>((std::min)(Free(), static_cast<size_t>(MAXDWORD)));
+		if(bytesToRead == 0) return 0;
+
+		DWORD bytesRead = source.Read(WriteAddress(), bytesToRead);
+		m_Size += bytesRead;
+
+		return bytesRead;
+	}
+
+	/**
+	 * Writes the readable bytes of the ring straight to a destination, consuming what was written
+	 * @param destination  the file or other destination to write to
+	 * @returns the number of bytes written
+	 */
+	DWORD DrainTo(IReaderWriter &destination)
+	{
+		DWORD bytesToWrite = static_cast<DWORD>((std::min)(m_Size, static_cast<size_t>(MAXDWORD)));
+		if(bytesToWrite == 0) return 0;
+
+		DWORD bytesWritten = destination.Write(ReadRegion(), bytesToWrite);
+		Consume(bytesWritten);
+
+		return bytesWritten;
+	}
+};
+
+} // end of namespace
\ No newline at end of file
@@ -0,0 +1,307 @@
+#pragma once
+
+#include <Echo\WinInclude.h>
+#include <Echo\Exceptions.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <new>
+
+namespace Echo
+{
+
+/**
+ * A monotonic allocator that hands out memory by bumping a pointer through large blocks.
+ * Deallocation does nothing; everything is released at once by Reset, which makes it
+ * suitable for scratch memory whose lifetime is bounded by a batch of work.
+ *
+ * Reset keeps the most recent block, so a workload that fits in one block reaches a
+ * steady state where it never calls the heap at all.
+ *
+ * The arena doesn't run destructors and isn't thread safe
+ */
+class MonotonicArena
+{
+private:
+	struct Block
+	{
+		Block *Previous;
+		size_t Size;
+	};
+
+	static const size_t HeaderSize = (sizeof(Block) + alignof(std::max_align_t) - 1) & ~(alignof(std::max_align_t) - 1);
+
+	Block *m_Head;
+	char *m_Next;
+	char *m_End;
+
+	const size_t m_InitialBlockSize;
+	size_t m_NextBlockSize;
+	size_t m_BytesAllocated;
+
+	static MonotonicArena *&CurrentSlot() noexcept
+	{
+		static thread_local MonotonicArena *current = nullptr;
+		return current;
+	}
+
+	static char *AlignUp(char *pointer, size_t alignment) noexcept
+	{
+		auto address = reinterpret_cast<uintptr_t>(pointer);
+		return pointer + ((alignment - (address & (alignment - 1))) & (alignment - 1));
+	}
+
+	void AddBlock(size_t minimumSize)
+	{
+		size_t size = (std::max)(m_NextBlockSize, minimumSize);
+		auto block = static_cast<Block*>(::operator new(HeaderSize + size));
+
+		block->Previous = m_Head;
+		block->Size = size;
+		m_Head = block;
+
+		m_Next = reinterpret_cast<char*>(block) + HeaderSize;
+		m_End = m_Next + size;
+
+		// Grow geometrically so a big batch needs only a few trips to the heap
+		m_NextBlockSize = size * 2;
+	}
+
+public:
+	/**
+	 * The default size of the first block
+	 */
+	static const size_t DefaultBlockSize = 64 * 1024;
+
+	/**
+	 * Initializes the instance. No memory is allocated until it's first needed
+	 * @param initialBlockSize  the size of the first block
+	 */
+	explicit MonotonicArena(size_t initialBlockSize = DefaultBlockSize) : m_Head(nullptr), m_Next(nullptr), m_End(nullptr), m_InitialBlockSize(initialBlockSize), m_NextBlockSize(initialBlockSize), m_BytesAllocated(0)
+	{
+		if(initialBlockSize == 0) throw ArgumentException(_T("initialBlockSize must be greater than zero"));
+	}
+
+	~MonotonicArena()
+	{
+		Release();
+	}
+
+	MonotonicArena(const MonotonicArena&) = delete;
+	MonotonicArena(MonotonicArena&&) = delete;
+
+	MonotonicArena &operator=(const MonotonicArena&) = delete;
+	MonotonicArena &operator=(MonotonicArena&&) = delete;
+
+	/**
+	 * Returns the arena the calling thread is currently working in, or null if there isn't one
+	 */
+	static MonotonicArena *Current() noexcept
+	{
+		return CurrentSlot();
+	}
+
+	/**
+	 * Makes an arena the calling thread's current arena
+	 * @param arena  the arena. May be null
+	 * @returns the previous current arena
+	 */
+	static MonotonicArena *SetCurrent(MonotonicArena *arena) noexcept
+	{
+		auto &current = CurrentSlot();
+		auto previous = current;
+		current = arena;
+
+		return previous;
+	}
+
+	/**
+	 * Returns the number of bytes handed out since the last reset
+	 */
+	size_t BytesAllocated() const noexcept
+	{
+		return m_BytesAllocated;
+	}
+
+	/**
+	 * Returns the number of bytes held in blocks
+	 */
+	size_t Capacity() const noexcept
+	{
+		size_t capacity = 0;
+
+		for(auto block = m_Head; block != nullptr; block = block->Previous)
+		{
+			capacity += block->Size;
+		}
+
+		return capacity;
+	}
+
+	/**
+	 * Allocates memory from the arena
+	 * @param bytes  the number of bytes
+	 * @param alignment  the alignment, which must be a power of two
+	 * @returns the memory, which remains valid until the arena is reset
+	 */
+	void *Allocate(size_t bytes, size_t alignment = alignof(std::max_align_t))
+	{
+		if(alignment == 0 || (alignment & (alignment - 1)) != 0) throw ArgumentException(_T("alignment must be a power of two"));
+
+		char *start = (m_Next == nullptr ? nullptr : AlignUp(m_Next, alignment));
+
+		if(start == nullptr || start > m_End || bytes > static_cast<size_t>(m_End - start))
+		{
+			// Allow for the worst case alignment padding in the new block
+			AddBlock(bytes + (alignment > alignof(std::max_align_t) ? alignment : 0));
+			start = AlignUp(m_Next, alignment);
+		}
+
+		m_Next = start + bytes;
+		m_BytesAllocated += bytes;
+
+		return start;
+	}
+
+	/**
+	 * Does nothing, as memory is only released by Reset
+	 */
+	void Deallocate(void*, size_t) noexcept
+	{
+	}
+
+	/**
+	 * Releases everything allocated from the arena, keeping the most recent block for reuse
+	 */
+	void Reset() noexcept
+	{
+		if(m_Head == nullptr) return;
+
+		Block *keep = m_Head;
+		Block *block = keep->Previous;
+
+		while(block != nullptr)
+		{
+			Block *previous = block->Previous;
+			::operator delete(block);
+			block = previous;
+		}
+
+		keep->Previous = nullptr;
+		m_Next = reinterpret_cast<char*>(keep) + HeaderSize;
+		m_End = m_Next + keep->Size;
+
+		m_NextBlockSize = (std::max)(m_InitialBlockSize, keep->Size);
+		m_BytesAllocated = 0;
+	}
+
+	/**
+	 * Releases everything allocated from the arena, including all of its blocks
+	 */
+	void Release() noexcept
+	{
+		while(m_Head != nullptr)
+		{
+			Block *previous = m_Head->Previous;
+			::operator delete(m_Head);
+			m_Head = previous;
+		}
+
+		m_Next = nullptr;
+		m_End = nullptr;
+
+		m_NextBlockSize = m_InitialBlockSize;
+		m_BytesAllocated = 0;
+	}
+};
+
+/**
+ * Makes an arena the calling thread's current arena for the lifetime of the scope
+ */
+class ArenaScope
+{
+private:
+	MonotonicArena *m_Previous;
+
+public:
+	/**
+	 * Initializes the instance
+	 * @param arena  the arena to make current
+	 */
+	explicit ArenaScope(MonotonicArena &arena) noexcept : m_Previous(MonotonicArena::SetCurrent(&arena))
+	{
+	}
+
+	~ArenaScope()
+	{
+		MonotonicArena::SetCurrent(m_Previous);
+	}
+
+	ArenaScope(const ArenaScope&) = delete;
+	ArenaScope(ArenaScope&&) = delete;
+
+	ArenaScope &operator=(const ArenaScope&) = delete;
+	ArenaScope &operator=(ArenaScope&&) = delete;
+};
+
+/**
+ * A standard library allocator that takes its memory from a MonotonicArena,
+ * so containers can be built in an arena
+ */
+template<typename T>
+class ArenaAllocator
+{
+private:
+	template<typename U> friend class ArenaAllocator;
+
+	MonotonicArena *m_Arena;
+
+public:
+	typedef T value_type;
+
+	/**
+	 * Initializes the instance
+	 * @param arena  the arena to allocate from
+	 */
+	ArenaAllocator(MonotonicArena &arena) noexcept : m_Arena(&arena)
+	{
+	}
+
+	template<typename U>
+	ArenaAllocator(const ArenaAllocator<U> &rhs) noexcept : m_Arena(rhs.m_Arena)
+	{
+	}
+
+	/**
+	 * Returns the arena the allocator takes its memory from
+	 */
+	MonotonicArena &Arena() const noexcept
+	{
+		return *m_Arena;
+	}
+
+	T *allocate(size_t count)
+	{
+		if(count > static_cast<size_t>(-1) / sizeof(T)) throw std::bad_alloc();
+		return static_cast<T*>(m_Arena->Allocate(count * sizeof(T), alignof(T)));
+	}
+
+	void deallocate(T *pointer, size_t count) noexcept
+	{
+		m_Arena->Deallocate(pointer, count * sizeof(T));
+	}
+
+	template<typename U>
+	bool operator==(const ArenaAllocator<U> &rhs) const noexcept
+	{
+		return m_Arena == rhs.m_Arena;
+	}
+
+	template<typename U>
+	bool operator!=(const ArenaAllocator<U> &rhs) const noexcept
+	{
+		return m_Arena != rhs.m_Arena;
+	}
+};
+
+} // end of namespace
\ No newline at end of file
@@ -0,0 +1,284 @@
+#pragma once
+
+#include <Echo\WinInclude.h>
+#include <Echo\CacheLine.h>
+#include <Echo\Exceptions.h>
+#include <Echo\WaitHandle.h>
+#include <Echo\SpinWait.h>
+#include <Echo\AddressWaiter.h>
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <utility>
+
+namespace Echo
+{
+
+/**
+ * A bounded, lock-free queue for any number of producers and consumers (Dmitry Vyukov's design).
+ *
+ * Each cell carries a sequence number that says whether it is ready to be written or read
+ * on the current lap of the ring, so producers and consumers only contend on their own
+ * position counter and never on a lock.
+ *
+ * The blocking Enqueue and Dequeue spin briefly and then park on WaitOnAddress, in the same
+ * way as the light events. The non-blocking calls only pay for a wake when someone is parked
+ */
+template<typename T>
+class MpmcQueue
+{
+private:
+	struct Cell
+	{
+		std::atomic<size_t> Sequence;
+		T Data;
+	};
+
+	std::unique_ptr<Cell[]> m_Cells;
+	const size_t m_Capacity;
+	const size_t m_Mask;
+	const unsigned m_SpinCount;
+
+	alignas(CacheLineSize) std::atomic<size_t> m_EnqueuePosition;
+	alignas(CacheLineSize) std::atomic<size_t> m_DequeuePosition;
+
+	alignas(CacheLineSize) std::atomic<LONG> m_ParkedProducers;
+	std::atomic<LONG> m_ParkedConsumers;
+
+	static size_t RoundUpToPowerOfTwo(size_t value)
+	{
+		size_t capacity = 2;
+		while(capacity < value) capacity <<= 1;
+
+		return capacity;
+	}
+
+	static std::chrono::milliseconds Remaining(bool infinite, const std::chrono::steady_clock::time_point &deadline)
+	{
+		if(infinite) return Infinite;
+
+		auto left = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now());
+		return (left.count() > 0 ? left : std::chrono::milliseconds(0));
+	}
+
+	/**
+	 * Waits for a position counter to move on from a value.
+	 * If the other position shows the queue isn't really full (or empty) then another thread is
+	 * part way through an operation on the cell we want, which will finish shortly, so we just spin
+	 */
+	bool WaitForProgress(const std::atomic<size_t> &position, size_t observed, bool stalled, std::atomic<LONG> &parked, SpinWait &spinner, bool infinite, const std::chrono::steady_clock::time_point &deadline)
+	{
+		if(!stalled)
+		{
+			spinner.SpinOnce();
+			return infinite || std::chrono::steady_clock::now() < deadline;
+		}
+
+		return AddressWaiter::WaitUntil(position, parked, m_SpinCount, Remaining(infinite, deadline), [observed](size_t current){return current != observed;});
+	}
+
+public:
+	/**
+	 * The default number of pause instructions a blocking call spins for before parking
+	 */
+	static const unsigned DefaultSpinCount = 1000;
+
+	/**
+	 * Initializes the instance
+	 * @param capacity  the minimum number of items the queue can hold. It is rounded up to a power of two
+	 * @param spinCount  how many pause instructions a blocking call spins for before parking
+	 */
+	explicit MpmcQueue(size_t capacity, unsigned spinCount = DefaultSpinCount) : m_Capacity(RoundUpToPowerOfTwo(capacity)), m_Mask(m_Capacity - 1), m_SpinCount(spinCount), m_EnqueuePosition(0), m_DequeuePosition(0), m_ParkedProducers(0), m_ParkedConsumers(0)
+	{
+		if(capacity == 0) throw ArgumentException(_T("capacity must be greater than zero"));
+
+		m_Cells.reset(new Cell[m_Capacity]);
+
+		for(size_t i = 0; i < m_Capacity; i++)
+		{
+			m_Cells[i].Sequence.store(i, std::memory_order_relaxed);
+		}
+	}
+
+	MpmcQueue(const MpmcQueue&) = delete;
+	MpmcQueue(MpmcQueue&&) = delete;
+
+	MpmcQueue &operator=(const MpmcQueue&) = delete;
+	MpmcQueue &operator=(MpmcQueue&&) = delete;
+
+	/**
+	 * Returns the number of items the queue can hold
+	 */
+	size_t Capacity() const noexcept
+	{
+		return m_Capacity;
+	}
+
+	/**
+	 * Returns an approximation of the number of items in the queue
+	 */
+	size_t Size() const noexcept
+	{
+		size_t dequeue = m_DequeuePosition.load(std::memory_order_acquire);
+		size_t enqueue = m_EnqueuePosition.load(std::memory_order_acquire);
+
+		return (enqueue > dequeue ? enqueue - dequeue : 0);
+	}
+
+	/**
+	 * Adds an item to the queue without waiting
+	 * @returns true if the item was added, false if the queue is full
+	 */
+	template<typename U>
+	bool TryEnqueue(U &&item)
+	{
+		Cell *cell = nullptr;
+		size_t position = m_EnqueuePosition.load(std::memory_order_relaxed);
+
+		for(;;)
+		{
+			cell = &m_Cells[position & m_Mask];
+
+			size_t sequence = cell->Sequence.load(std::memory_order_acquire);
+			auto difference = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position);
+
+			if(difference == 0)
+			{
+				// The cell is free on this lap, so try to claim it
+				if(m_EnqueuePosition.compare_exchange_weak(position, position + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) break;
+			}
+			else if(difference < 0)
+			{
+				// The cell still holds an item from the previous lap
+				return false;
+			}
+			else
+			{
+				position = m_EnqueuePosition.load(std::memory_order_relaxed);
+			}
+		}
+
+		cell->Data = std::forward<U>(item);
+		cell->Sequence.store(position + 1, std::memory_order_release);
+
+		if(m_ParkedConsumers.load(std::memory_order_seq_cst) != 0) AddressWaiter::WakeAll(m_EnqueuePosition);
+		return true;
+	}
+
+	/**
+	 * Removes an item from the queue without waiting
+	 * @param item  receives the item
+	 * @returns true if an item was removed, false if the queue is empty
+	 */
+	bool TryDequeue(T &item)
+	{
+		Cell *cell = nullptr;
+		size_t position = m_DequeuePosition.load(std::memory_order_relaxed);
+
+		for(;;)
+		{
+			cell = &m_Cells[position & m_Mask];
+
+			size_t sequence = cell->Sequence.load(std::memory_order_acquire);
+			auto difference = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position + 1);
+
+			if(difference == 0)
+			{
+				// The cell has been written on this lap, so try to claim it
+				if(m_DequeuePosition.compare_exchange_weak(position, position + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) break;
+			}
+			else if(difference < 0)
+			{
+				// Nothing has been written to the cell yet
+				return false;
+			}
+			else
+			{
+				position = m_DequeuePosition.load(std::memory_order_relaxed);
+			}
+		}
+
+		item = std::move(cell->Data);
+
+		// Free the cell for the next lap
+		cell->Sequence.store(position + m_Capacity, std::memory_order_release);
+
+		if(m_ParkedProducers.load(std::memory_order_seq_cst) != 0) AddressWaiter::WakeAll(m_DequeuePosition);
+		return true;
+	}
+
+	/**
+	 * Adds an item to the queue, waiting forever for space if the queue is full
+	 */
+	template<typename U>
+	void Enqueue(U &&item)
+	{
+		Enqueue(std::forward<U>(item), Infinite);
+	}
+
+	/**
+	 * Adds an item to the queue, waiting for space if the queue is full
+	 * @param duration  how long to wait for
+	 * @returns true if the item was added, false on timeout
+	 */
+	template<typename U>
+	bool Enqueue(U &&item, const std::chrono::milliseconds &duration)
+	{
+		const bool infinite = (duration == Infinite);
+		const auto deadline = std::chrono::steady_clock::now() + duration;
+
+		SpinWait spinner;
+
+		for(;;)
+		{
+			if(TryEnqueue(std::forward<U>(item))) return true;
+
+			size_t dequeue = m_DequeuePosition.load(std::memory_order_seq_cst);
+			bool full = (m_EnqueuePosition.load(std::memory_order_seq_cst) - dequeue >= m_Capacity);
+
+			if(!WaitForProgress(m_DequeuePosition, dequeue, full, m_ParkedProducers, spinner, infinite, deadline))
+			{
+				return TryEnqueue(std::forward<U>(item));
+			}
+		}
+	}
+
+	/**
+	 * Removes an item from the queue, waiting forever if the queue is empty
+	 * @param item  receives the item
+	 */
+	void Dequeue(T &item)
+	{
+		Dequeue(item, Infinite);
+	}
+
+	/**
+	 * Removes an item from the queue, waiting if the queue is empty
+	 * @param item  receives the item
+	 * @param duration  how long to wait for
+	 * @returns true if an item was removed, false on timeout
+	 */
+	bool Dequeue(T &item, const std::chrono::milliseconds &duration)
+	{
+		const bool infinite = (duration == Infinite);
+		const auto deadline = std::chrono::steady_clock::now() + duration;
+
+		SpinWait spinner;
+
+		for(;;)
+		{
+			if(TryDequeue(item)) return true;
+
+			size_t enqueue = m_EnqueuePosition.load(std::memory_order_seq_cst);
+			bool empty = (enqueue == m_DequeuePosition.load(std::memory_order_seq_cst));
+
+			if(!WaitForProgress(m_EnqueuePosition, enqueue, empty, m_ParkedConsumers, spinner, infinite, deadline))
+			{
+				return TryDequeue(item);
+			}
+		}
+	}
+};
+
+} // end of namespace
\ No newline at end of file
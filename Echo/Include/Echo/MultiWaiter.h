@@ -4,6 +4,7 @@
 #include <Echo\WaitHandle.h>
 #include <Echo\Exceptions.h>
 
+#include <utility>
 #include <vector>
 
 namespace Echo {
@@ -16,6 +17,33 @@ class MultiWaiter
 private:
 	std::vector<HANDLE> m_Handles;
 
+	// Where the next WaitAnyAll starts looking, so that low indexes can't starve the rest
+	mutable size_t m_NextStart = 0;
+
+	/**
+	 * Interprets the outcome of a wait for any handle
+	 * @returns the 0 based index of the signalled handle, or -1 if nothing was signalled
+	 */
+	static int AnyOutcome(DWORD outcome, size_t size)
+	{
+		if(outcome >= WAIT_OBJECT_0 && outcome < (WAIT_OBJECT_0 + size))
+		{
+			return static_cast<int>(outcome - WAIT_OBJECT_0);
+		}
+		else if(outcome >= WAIT_ABANDONED_0 && outcome < (WAIT_ABANDONED_0 + size))
+		{
+			throw WindowsException(_T("wait abandoned"));
+		}
+		else if(outcome == WAIT_FAILED)
+		{
+			throw WindowsException(_T("failed"));
+		}
+		else
+		{
+			return -1;
+		}
+	}
+
 public:
 	/**
 	 * Initializes the instance
@@ -31,6 +59,7 @@ public:
 	MultiWaiter(MultiWaiter &&rhs)
 	{
 		m_Handles.swap(rhs.m_Handles);
+		std::swap(m_NextStart, rhs.m_NextStart);
 	}
 
 	/**
@@ -43,6 +72,9 @@ public:
 		{
 			m_Handles.swap(rhs.m_Handles);
 			rhs.m_Handles.clear();
+
+			m_NextStart = rhs.m_NextStart;
+			rhs.m_NextStart = 0;
 		}
 
 		return *this;
@@ -125,23 +157,72 @@ public:
 		auto size = m_Handles.size();
 
 		auto outcome = ::WaitForMultipleObjects(size,handles, FALSE, ms);
-		if(outcome >= WAIT_OBJECT_0 && outcome < (WAIT_OBJECT_0 + size))
-		{
-			// One was signalled
-			return static_cast<int>(outcome);
-		}
-		else if(outcome >= WAIT_ABANDONED_0 && outcome < (WAIT_ABANDONED_0 + size))
-		{
-			throw WindowsException(_T("wait abandoned"));
-		}
-		else if(outcome == WAIT_FAILED)
+		return AnyOutcome(outcome, size);
+	}
+
+	/**
+	 * Waits forever for any of the handles to be signalled
+	 * @returns the 0 based indexes of every signalled handle, in the order they were serviced
+	 */
+	std::vector<int> WaitAnyAll() const
+	{
+		return WaitAnyAll(Infinite);
+	}
+
+	/**
+	 * Waits for any of the handles to be signalled and then collects every other handle
+	 * that is also signalled, so one call can service them all.
+	 * Successive calls start looking one past the last handle serviced, so every handle gets
+	 * its turn at the front. As with WaitAny, the wait consumes the signal of auto reset
+	 * events and semaphores that are returned
+	 * @param duration  how long to wait for
+	 * @returns the 0 based indexes of every signalled handle, in the order they were serviced.
+	 *          The vector is empty if nothing was signalled
+	 */
+	std::vector<int> WaitAnyAll(const std::chrono::milliseconds &duration) const
+	{
+		std::vector<int> signalled;
+
+		auto size = m_Handles.size();
+		if(size > MAXIMUM_WAIT_OBJECTS) throw WindowsException(_T("too many handles"));
+
+		// Rotate the handles so the wait favours the handle we start at
+		HANDLE rotated[MAXIMUM_WAIT_OBJECTS];
+		const size_t start = (size == 0 ? 0 : m_NextStart % size);
+
+		for(size_t i = 0; i < size; i++)
 		{
-			throw WindowsException(_T("failed"));
+			rotated[i] = m_Handles[(start + i) % size];
 		}
-		else
+
+		auto ms = static_cast<DWORD>(duration.count());
+		int index = AnyOutcome(::WaitForMultipleObjects(size, rotated, FALSE, ms), size);
+		if(index == -1) return signalled;
+
+		size_t position = static_cast<size_t>(index);
+		signalled.push_back(static_cast<int>((start + position) % size));
+
+		// Sweep the rest without waiting. Each wait reports the first signalled handle after the last one we found
+		for(position++; position < size; position++)
 		{
-			return -1;
+			auto remaining = size - position;
+			index = AnyOutcome(::WaitForMultipleObjects(remaining, rotated + position, FALSE, 0), remaining);
+			if(index == -1) break;
+
+			position += index;
+			signalled.push_back(static_cast<int>((start + position) % size));
 		}
+
+		m_NextStart = static_cast<size_t>(signalled.back()) + 1;
+		return signalled;
+	}
+
+	/**
+	 * Returns the index that the next WaitAnyAll will start looking at
+	 */
+	size_t NextStart() const noexcept
+	{
+		return (m_Handles.size() == 0 ? 0 : m_NextStart % m_Handles.size());
 	}
 
 };
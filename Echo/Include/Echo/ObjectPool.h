@@ -0,0 +1,120 @@
+#pragma once
+
+#include <Echo\SlabPool.h>
+
+#include <memory>
+#include <new>
+#include <utility>
+
+namespace Echo
+{
+
+/**
+ * A pool of storage for objects of one type, for hot objects that are created and destroyed at a high rate.
+ *
+ * Storage comes from a SlabPool, so in the steady state Make and Destroy only touch the calling
+ * thread's magazines, and an object destroyed on another thread still returns its storage to this pool.
+ *
+ * The pool must outlive the objects it makes
+ */
+template<typename T>
+class ObjectPool
+{
+private:
+	SlabPool m_Slabs;
+
+public:
+	/**
+	 * Destroys objects made by a pool, handing their storage back to it
+	 */
+	class Deleter
+	{
+	private:
+		ObjectPool *m_Pool;
+
+	public:
+		Deleter() noexcept : m_Pool(nullptr)
+		{
+		}
+
+		explicit Deleter(ObjectPool *pool) noexcept : m_Pool(pool)
+		{
+		}
+
+		void operator()(T *object) const noexcept
+		{
+			m_Pool->Destroy(object);
+		}
+	};
+
+	/**
+	 * An owning pointer to an object made by a pool
+	 */
+	typedef std::unique_ptr<T, Deleter> Pointer;
+
+	/**
+	 * Initializes the instance
+	 * @param preallocate  the number of objects to allocate storage for up front
+	 */
+	explicit ObjectPool(size_t preallocate = 0) : m_Slabs(sizeof(T), alignof(T), preallocate)
+	{
+	}
+
+	ObjectPool(const ObjectPool&) = delete;
+	ObjectPool(ObjectPool&&) = delete;
+
+	ObjectPool &operator=(const ObjectPool&) = delete;
+	ObjectPool &operator=(ObjectPool&&) = delete;
+
+	/**
+	 * Returns the number of objects the pool has allocated storage for
+	 */
+	size_t Capacity() const noexcept
+	{
+		return m_Slabs.Capacity();
+	}
+
+	/**
+	 * Allocates storage for at least count more objects and places it in the depot
+	 * @param count  the number of objects
+	 */
+	void Reserve(size_t count)
+	{
+		m_Slabs.Reserve(count);
+	}
+
+	/**
+	 * Constructs an object in storage from the pool
+	 * @param args  the constructor arguments
+	 * @returns a pointer that hands the storage back to the pool when the object is destroyed
+	 */
+	template<typename... ARGS>
+	Pointer Make(ARGS&&... args)
+	{
+		void *storage = m_Slabs.Allocate();
+
+		try
+		{
+			return Pointer(new(storage) T(std::forward<ARGS>(args)...), Deleter(this));
+		}
+		catch(...)
+		{
+			m_Slabs.Free(storage);
+			throw;
+		}
+	}
+
+	/**
+	 * Destroys an object made by the pool. Normally called by a Pointer
+	 * @param object  the object to destroy. May be null
+	 */
+	void Destroy(T *object) noexcept
+	{
+		if(object == nullptr) return;
+
+		object->~T();
+		m_Slabs.Free(object);
+	}
+};
+
+} // end of namespace
\ No newline at end of file
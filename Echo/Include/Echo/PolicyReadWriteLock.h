@@ -0,0 +1,496 @@
+#pragma once
+
+#include <Echo\WinInclude.h>
+#include <Echo\Guard.h>
+#include <Echo\Exceptions.h>
+#include <Echo\CriticalSection.h>
+#include <Echo\ConditionalVariable.h>
+
+#include <utility>
+
+namespace Echo
+{
+
+/**
+ * Readers are admitted whenever no writer holds the lock.
+ * Gives the best read throughput, but writers can starve under constant read load
+ */
+struct ReaderPreferringPolicy
+{
+	static const bool ReadersYieldToWaitingWriters = false;
+	static const bool WritersYieldToWaitingReaders = true;
+	static const bool AdmitWaitingReadersOnWriterExit = false;
+};
+
+/**
+ * New readers queue behind any waiting writer, and writers hand the lock to each other first.
+ * Bounds writer latency, but readers can starve under constant write load
+ */
+struct WriterPreferringPolicy
+{
+	static const bool ReadersYieldToWaitingWriters = true;
+	static const bool WritersYieldToWaitingReaders = false;
+	static const bool AdmitWaitingReadersOnWriterExit = false;
+};
+
+/**
+ * Reader and writer phases alternate. New readers queue behind a waiting writer,
+ * and when a writer exits every reader that queued behind it is admitted as a group
+ * before the next writer. Neither side can starve the other
+ */
+struct PhaseFairPolicy
+{
+	static const bool ReadersYieldToWaitingWriters = true;
+	static const bool WritersYieldToWaitingReaders = false;
+	static const bool AdmitWaitingReadersOnWriterExit = true;
+};
+
+/**
+ * A reader-writer lock whose fairness is controlled by a policy, with support
+ * for an upgradeable shared acquisition.
+ *
+ * An upgradeable holder coexists with ordinary readers but excludes writers and other
+ * upgradeable holders, so it can later upgrade to exclusive without releasing the lock.
+ * Whilst an upgrade is pending new readers are held back regardless of the policy.
+ *
+ * Unlike ReadWriteLock the state is kept under a critical section rather than in an SRWLOCK,
+ * so acquisitions are more expensive. Use it where writer latency matters
+ */
+template<typename POLICY>
+class PolicyReadWriteLock
+{
+private:
+	mutable CriticalSection m_SyncRoot;
+	ConditionalVariable m_ReadersCanEnter;
+	ConditionalVariable m_WritersCanEnter;
+
+	ULONG m_ActiveReaders;
+	ULONG m_WaitingReaders;
+	ULONG m_WaitingWriters;
+	ULONG m_WaitingUpgraders;
+	bool m_WriterActive;
+	bool m_UpgraderActive;
+	bool m_UpgradePending;
+
+	// Bumped whenever waiting readers are handed the lock by an exiting writer
+	ULONG64 m_ReaderAdmission;
+
+	bool ReaderMustWait() const noexcept
+	{
+		if(m_WriterActive || m_UpgradePending) return true;
+		return POLICY::ReadersYieldToWaitingWriters && m_WaitingWriters != 0;
+	}
+
+	bool UpgraderMustWait() const noexcept
+	{
+		return m_UpgraderActive || ReaderMustWait();
+	}
+
+	bool WriterMustWait() const noexcept
+	{
+		if(m_WriterActive || m_UpgraderActive || m_ActiveReaders != 0) return true;
+		return POLICY::WritersYieldToWaitingReaders && m_WaitingReaders != 0;
+	}
+
+	/**
+	 * Waits on the readers condition until the caller can enter or is handed the lock.
+	 * The lock must be held
+	 * @returns true if an exiting writer admitted the caller, otherwise false
+	 */
+	bool WaitAsReader()
+	{
+		m_WaitingReaders++;
+		const ULONG64 admission = m_ReaderAdmission;
+
+		while(admission == m_ReaderAdmission && ReaderMustWait())
+		{
+			m_ReadersCanEnter.Wait(m_SyncRoot);
+		}
+
+		if(admission != m_ReaderAdmission) return true;
+
+		m_WaitingReaders--;
+		return false;
+	}
+
+	/**
+	 * Wakes whoever is next once the lock has been released by a writer or upgrader.
+	 * The lock must be held
+	 */
+	void WakeWaiters() noexcept
+	{
+		// Upgraders wait alongside the readers
+		if(m_WaitingReaders != 0 || m_WaitingUpgraders != 0) m_ReadersCanEnter.NotifyAll();
+		if(m_WaitingWriters != 0 || m_UpgradePending) m_WritersCanEnter.NotifyAll();
+	}
+
+public:
+	/**
+	 * Initializes the instance
+	 */
+	PolicyReadWriteLock() noexcept : m_ActiveReaders(0), m_WaitingReaders(0), m_WaitingWriters(0), m_WaitingUpgraders(0), m_WriterActive(false), m_UpgraderActive(false), m_UpgradePending(false), m_ReaderAdmission(0)
+	{
+	}
+
+	PolicyReadWriteLock(const PolicyReadWriteLock&) = delete;
+	PolicyReadWriteLock(PolicyReadWriteLock&&) = delete;
+
+	PolicyReadWriteLock &operator=(const PolicyReadWriteLock&) = delete;
+	PolicyReadWriteLock &operator=(PolicyReadWriteLock&&) = delete;
+
+	/**
+	 * Enters the lock in exclusive mode
+	 */
+	void Enter()
+	{
+		Guard<CriticalSection> lock(m_SyncRoot);
+
+		m_WaitingWriters++;
+		while(WriterMustWait())
+		{
+			m_WritersCanEnter.Wait(m_SyncRoot);
+		}
+
+		m_WaitingWriters--;
+		m_WriterActive = true;
+	}
+
+	/**
+	 * Attempts to enter the lock in exclusive mode without waiting
+	 * @returns true if the lock was entered, otherwise false
+	 */
+	bool TryEnter()
+	{
+		Guard<CriticalSection> lock(m_SyncRoot);
+
+		if(WriterMustWait()) return false;
+
+		m_WriterActive = true;
+		return true;
+	}
+
+	/**
+	 * Exits a lock that was acquired in exclusive mode
+	 */
+	void Exit()
+	{
+		Guard<CriticalSection> lock(m_SyncRoot);
+
+		m_WriterActive = false;
+
+		if(POLICY::AdmitWaitingReadersOnWriterExit && m_WaitingReaders != 0)
+		{
+			// Hand the lock to the readers that queued behind us before the next writer gets a turn
+			m_ActiveReaders += m_WaitingReaders;
+			m_WaitingReaders = 0;
+			m_ReaderAdmission++;
+			m_ReadersCanEnter.NotifyAll();
+			return;
+		}
+
+		WakeWaiters();
+	}
+
+	/**
+	 * Enters the lock in shared mode
+	 */
+	void EnterShared()
+	{
+		Guard<CriticalSection> lock(m_SyncRoot);
+
+		if(ReaderMustWait() && WaitAsReader()) return;
+
+		m_ActiveReaders++;
+	}
+
+	/**
+	 * Attempts to enter the lock in shared mode without waiting
+	 * @returns true if the lock was entered, otherwise false
+	 */
+	bool TryEnterShared()
+	{
+		Guard<CriticalSection> lock(m_SyncRoot);
+
+		if(ReaderMustWait()) return false;
+
+		m_ActiveReaders++;
+		return true;
+	}
+
+	/**
+	 * Exits a lock that was acquired in shared mode
+	 */
+	void ExitShared()
+	{
+		Guard<CriticalSection> lock(m_SyncRoot);
+
+		if(--m_ActiveReaders == 0 && (m_WaitingWriters != 0 || m_UpgradePending))
+		{
+			m_WritersCanEnter.NotifyAll();
+		}
+	}
+
+	/**
+	 * Enters the lock in upgradeable mode.
+	 * Ordinary readers may still enter, but writers and other upgradeable holders may not
+	 */
+	void EnterUpgradeable()
+	{
+		Guard<CriticalSection> lock(m_SyncRoot);
+
+		// An upgrader can't be handed the lock by an exiting writer, so it isn't a waiting reader
+		m_WaitingUpgraders++;
+		while(UpgraderMustWait())
+		{
+			m_ReadersCanEnter.Wait(m_SyncRoot);
+		}
+
+		m_WaitingUpgraders--;
+		m_UpgraderActive = true;
+	}
+
+	/**
+	 * Attempts to enter the lock in upgradeable mode without waiting
+	 * @returns true if the lock was entered, otherwise false
+	 */
+	bool TryEnterUpgradeable()
+	{
+		Guard<CriticalSection> lock(m_SyncRoot);
+
+		if(UpgraderMustWait()) return false;
+
+		m_UpgraderActive = true;
+		return true;
+	}
+
+	/**
+	 * Exits a lock that was acquired in upgradeable mode
+	 */
+	void ExitUpgradeable()
+	{
+		Guard<CriticalSection> lock(m_SyncRoot);
+
+		m_UpgraderActive = false;
+		WakeWaiters();
+	}
+
+	/**
+	 * Converts an upgradeable acquisition into an exclusive one, waiting for
+	 * any readers to leave. New readers are held back until the upgrade completes
+	 */
+	void Upgrade()
+	{
+		Guard<CriticalSection> lock(m_SyncRoot);
+
+		if(m_UpgraderActive == false) throw Exception(_T("lock is not held in upgradeable mode"));
+
+		m_UpgradePending = true;
+		while(m_ActiveReaders != 0)
+		{
+			m_WritersCanEnter.Wait(m_SyncRoot);
+		}
+
+		m_UpgradePending = false;
+		m_UpgraderActive = false;
+		m_WriterActive = true;
+	}
+
+	/**
+	 * Converts an exclusive acquisition back into an upgradeable one,
+	 * letting readers back in without giving up the right to upgrade again
+	 */
+	void Downgrade()
+	{
+		Guard<CriticalSection> lock(m_SyncRoot);
+
+		if(m_WriterActive == false) throw Exception(_T("lock is not held in exclusive mode"));
+
+		m_WriterActive = false;
+		m_UpgraderActive = true;
+
+		if(m_WaitingReaders != 0 || m_WaitingUpgraders != 0) m_ReadersCanEnter.NotifyAll();
+	}
+};
+
+using ReaderPreferringReadWriteLock = PolicyReadWriteLock<ReaderPreferringPolicy>;
+using WriterPreferringReadWriteLock = PolicyReadWriteLock<WriterPreferringPolicy>;
+using PhaseFairReadWriteLock = PolicyReadWriteLock<PhaseFairPolicy>;
+
+/**
+ * Locks a policy read write lock in exclusive mode
+ */
+template<typename POLICY>
+class Guard<PolicyReadWriteLock<POLICY>>
+{
+private:
+	PolicyReadWriteLock<POLICY> &m_Lock;
+
+public:
+	/**
+	 * Exclusively acquires the read write lock
+	 */
+	explicit Guard(PolicyReadWriteLock<POLICY> &lock) : m_Lock(lock)
+	{
+		m_Lock.Enter();
+	}
+
+	Guard(const Guard &) = delete;
+	Guard(Guard &&) = delete;
+
+	Guard &operator=(Guard &&) = delete;
+	Guard &operator=(const Guard &) = delete;
+
+	/**
+	 * Destroys the instance by releasing the lock
+	 */
+	~Guard() noexcept
+	{
+		m_Lock.Exit();
+	}
+};
+
+template<typename POLICY>
+class UniqueGuard<PolicyReadWriteLock<POLICY>>
+{
+private:
+	PolicyReadWriteLock<POLICY> *m_Lock;
+
+public:
+	/**
+	 * Exclusively acquires the read write lock
+	 */
+	explicit UniqueGuard(PolicyReadWriteLock<POLICY> &lock) : m_Lock(&lock)
+	{
+		m_Lock->Enter();
+	}
+
+	UniqueGuard(UniqueGuard &&rhs) : m_Lock(nullptr)
+	{
+		std::swap(m_Lock, rhs.m_Lock);
+	}
+
+	UniqueGuard(const UniqueGuard &) = delete;
+
+	UniqueGuard &operator=(UniqueGuard &&rhs) noexcept
+	{
+		if(this != &rhs)
+		{
+			std::swap(m_Lock, rhs.m_Lock);
+		}
+
+		return *this;
+	}
+
+	/**
+	 * Destroys the instance by releasing the lock
+	 */
+	~UniqueGuard() noexcept
+	{
+		if(m_Lock) m_Lock->Exit();
+	}
+};
+
+/**
+ * Locks a policy read write lock in shared mode
+ */
+template<typename POLICY>
+class PolicyReadWriteLockSharedGuard
+{
+private:
+	PolicyReadWriteLock<POLICY> &m_Lock;
+
+public:
+	/**
+	 * Acquires the read write lock in shared mode
+	 */
+	explicit PolicyReadWriteLockSharedGuard(PolicyReadWriteLock<POLICY> &lock) : m_Lock(lock)
+	{
+		m_Lock.EnterShared();
+	}
+
+	PolicyReadWriteLockSharedGuard(const PolicyReadWriteLockSharedGuard &) = delete;
+	PolicyReadWriteLockSharedGuard(PolicyReadWriteLockSharedGuard &&) = delete;
+	PolicyReadWriteLockSharedGuard &operator=(const PolicyReadWriteLockSharedGuard &) = delete;
+	PolicyReadWriteLockSharedGuard &operator=(PolicyReadWriteLockSharedGuard &&) = delete;
+
+	/**
+	 * Destroys the instance by releasing the shared lock
+	 */
+	~PolicyReadWriteLockSharedGuard() noexcept
+	{
+		m_Lock.ExitShared();
+	}
+};
+
+/**
+ * Locks a policy read write lock in upgradeable mode,
+ * optionally upgrading to exclusive mode later on
+ */
+template<typename POLICY>
+class PolicyReadWriteLockUpgradeGuard
+{
+private:
+	PolicyReadWriteLock<POLICY> &m_Lock;
+	bool m_Upgraded;
+
+public:
+	/**
+	 * Acquires the read write lock in upgradeable mode
+	 */
+	explicit PolicyReadWriteLockUpgradeGuard(PolicyReadWriteLock<POLICY> &lock) : m_Lock(lock), m_Upgraded(false)
+	{
+		m_Lock.EnterUpgradeable();
+	}
+
+	PolicyReadWriteLockUpgradeGuard(const PolicyReadWriteLockUpgradeGuard &) = delete;
+	PolicyReadWriteLockUpgradeGuard(PolicyReadWriteLockUpgradeGuard &&) = delete;
+	PolicyReadWriteLockUpgradeGuard &operator=(const PolicyReadWriteLockUpgradeGuard &) = delete;
+	PolicyReadWriteLockUpgradeGuard &operator=(PolicyReadWriteLockUpgradeGuard &&) = delete;
+
+	/**
+	 * Destroys the instance by releasing the lock in whichever mode it is held
+	 */
+	~PolicyReadWriteLockUpgradeGuard() noexcept
+	{
+		if(m_Upgraded)
+		{
+			m_Lock.Exit();
+		}
+		else
+		{
+			m_Lock.ExitUpgradeable();
+		}
+	}
+
+	/**
+	 * Indicates if the lock has been upgraded to exclusive mode
+	 */
+	bool IsUpgraded() const noexcept
+	{
+		return m_Upgraded;
+	}
+
+	/**
+	 * Upgrades the lock to exclusive mode
+	 */
+	void Upgrade()
+	{
+		if(m_Upgraded) return;
+
+		m_Lock.Upgrade();
+		m_Upgraded = true;
+	}
+
+	/**
+	 * Downgrades the lock back to upgradeable mode
+	 */
+	void Downgrade()
+	{
+		if(m_Upgraded == false) return;
+
+		m_Lock.Downgrade();
+		m_Upgraded = false;
+	}
+};
+
+} // end of namespace
\ No newline at end of file
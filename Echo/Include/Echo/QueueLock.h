@@ -0,0 +1,321 @@
+#pragma once
+
+#include <Echo\WinInclude.h>
+#include <Echo\Guard.h>
+#include <Echo\CacheLine.h>
+#include <Echo\SpinWait.h>
+#include <Echo\AddressWaiter.h>
+
+#include <atomic>
+#include <malloc.h>
+#include <new>
+#include <utility>
+
+namespace Echo
+{
+
+/**
+ * A fair MCS queue lock.
+ * Threads acquire the lock in the order they arrive and each waiter spins on
+ * a flag in its own cache line, so a release only touches the next waiter's line.
+ * A waiter that spins for too long parks itself with WaitOnAddress.
+ *
+ * Every acquisition needs a Node that stays alive until the matching Exit,
+ * which is what the Guard specializations provide
+ */
+class QueueLock
+{
+public:
+	/**
+	 * A waiter's place in the queue
+	 */
+	class alignas(CacheLineSize) Node
+	{
+	private:
+		friend class QueueLock;
+
+		std::atomic<Node*> m_Next;
+		std::atomic<LONG> m_State;
+
+	public:
+		Node() noexcept : m_Next(nullptr), m_State(0)
+		{
+		}
+
+		Node(const Node&) = delete;
+		Node &operator=(const Node&) = delete;
+	};
+
+private:
+	enum : LONG
+	{
+		Granted = 0,
+		Spinning = 1,
+		Parked = 2
+	};
+
+	alignas(CacheLineSize) std::atomic<Node*> m_Tail;
+	const unsigned m_SpinCount;
+
+	void WaitForGrant(Node &node)
+	{
+		SpinWait spinner;
+
+		while(spinner.TotalPauses() < m_SpinCount)
+		{
+			if(node.m_State.load(std::memory_order_acquire) == Granted) return;
+			spinner.SpinOnce();
+		}
+
+		LONG expected = Spinning;
+		if(node.m_State.compare_exchange_strong(expected, Parked, std::memory_order_acq_rel) == false)
+		{
+			// We were granted the lock whilst trying to park
+			return;
+		}
+
+		while(node.m_State.load(std::memory_order_acquire) != Granted)
+		{
+			AddressWaiter::Wait(node.m_State, static_cast<LONG>(Parked));
+		}
+	}
+
+	static void Grant(Node &node) noexcept
+	{
+		if(node.m_State.exchange(Granted, std::memory_order_release) == Parked)
+		{
+			AddressWaiter::WakeOne(node.m_State);
+		}
+	}
+
+public:
+	/**
+	 * The default number of pause instructions a waiter spins for before parking
+	 */
+	static const unsigned DefaultSpinCount = 4000;
+
+	/**
+	 * Initializes the instance
+	 * @param spinCount  how many pause instructions a waiter spins for before parking
+	 */
+	explicit QueueLock(unsigned spinCount = DefaultSpinCount) noexcept : m_Tail(nullptr), m_SpinCount(spinCount)
+	{
+	}
+
+	QueueLock(const QueueLock&) = delete;
+	QueueLock(QueueLock&&) = delete;
+
+	QueueLock &operator=(const QueueLock&) = delete;
+	QueueLock &operator=(QueueLock&&) = delete;
+
+	/**
+	 * Enters the lock, queuing behind any existing waiters
+	 * @param node  the node for this acquisition. It must remain valid until Exit is called
+	 */
+	void Enter(Node &node)
+	{
+		node.m_Next.store(nullptr, std::memory_order_relaxed);
+		node.m_State.store(Spinning, std::memory_order_relaxed);
+
+		Node *predecessor = m_Tail.exchange(&node, std::memory_order_acq_rel);
+		if(predecessor == nullptr) return;
+
+		predecessor->m_Next.store(&node, std::memory_order_release);
+		WaitForGrant(node);
+	}
+
+	/**
+	 * Attempts to enter the lock without waiting
+	 * @param node  the node for this acquisition. It must remain valid until Exit is called
+	 * @returns true if the lock was entered, otherwise false
+	 */
+	bool TryEnter(Node &node) noexcept
+	{
+		node.m_Next.store(nullptr, std::memory_order_relaxed);
+		node.m_State.store(Granted, std::memory_order_relaxed);
+
+		Node *expected = nullptr;
+		return m_Tail.compare_exchange_strong(expected, &node, std::memory_order_acq_rel, std::memory_order_relaxed);
+	}
+
+	/**
+	 * Exits the lock, handing it to the next waiter in the queue
+	 * @param node  the node that was passed to Enter or TryEnter
+	 */
+	void Exit(Node &node) noexcept
+	{
+		Node *next = node.m_Next.load(std::memory_order_acquire);
+
+		if(next == nullptr)
+		{
+			// If we're still the tail there's nobody waiting
+			Node *expected = &node;
+			if(m_Tail.compare_exchange_strong(expected, nullptr, std::memory_order_release, std::memory_order_relaxed)) return;
+
+			// Someone has joined the queue but hasn't linked themselves in yet
+			while((next = node.m_Next.load(std::memory_order_acquire)) == nullptr)
+			{
+				YieldProcessor();
+			}
+		}
+
+		Grant(*next);
+	}
+
+	/**
+	 * Returns how many pause instructions a waiter spins for before parking
+	 */
+	unsigned SpinCount() const noexcept
+	{
+		return m_SpinCount;
+	}
+};
+
+/**
+ * Locks a queue lock
+ */
+template<>
+class Guard<QueueLock>
+{
+private:
+	QueueLock &m_Lock;
+	QueueLock::Node m_Node;
+
+public:
+	/**
+	 * Initializes the instance by entering the lock
+	 */
+	explicit Guard(QueueLock &lock) : m_Lock(lock)
+	{
+		m_Lock.Enter(m_Node);
+	}
+
+	Guard(const Guard &) = delete;
+	Guard &operator=(const Guard &) = delete;
+	Guard &operator=(Guard &&) = delete;
+
+	/**
+	 * Destroys the instance by exitting the lock
+	 */
+	~Guard() noexcept
+	{
+		m_Lock.Exit(m_Node);
+	}
+};
+
+template<>
+class TryGuard<QueueLock>
+{
+private:
+	QueueLock &m_Lock;
+	QueueLock::Node m_Node;
+	const bool m_Locked;
+
+public:
+	/**
+	 * Initializes the instance by attempting to enter the lock
+	 */
+	TryGuard(QueueLock &lock) : m_Lock(lock), m_Locked(lock.TryEnter(m_Node))
+	{
+	}
+
+	TryGuard(const TryGuard &) = delete;
+	TryGuard &operator=(const TryGuard &) = delete;
+	TryGuard &operator=(TryGuard &&) = delete;
+
+	/**
+	 * Inidicates if the lock was entered
+	 */
+	bool IsLocked() const
+	{
+		return m_Locked;
+	}
+
+	/**
+	 * Destroys the instance exitting the lock if it was entered
+	 */
+	~TryGuard()
+	{
+		if(m_Locked)
+		{
+			m_Lock.Exit(m_Node);
+		}
+	}
+};
+
+template<>
+class UniqueGuard<QueueLock>
+{
+private:
+	QueueLock *m_Lock;
+
+	// The node has to stay put whilst the guard moves around, so it lives on the heap
+	QueueLock::Node *m_Node;
+
+	static QueueLock::Node *AllocateNode()
+	{
+		void *memory = ::_aligned_malloc(sizeof(QueueLock::Node), alignof(QueueLock::Node));
+		if(memory == nullptr) throw std::bad_alloc();
+
+		return new(memory) QueueLock::Node();
+	}
+
+	static void FreeNode(QueueLock::Node *node) noexcept
+	{
+		node->~Node();
+		::_aligned_free(node);
+	}
+
+public:
+	/**
+	 * Initializes the instance by entering the lock
+	 */
+	explicit UniqueGuard(QueueLock &lock) : m_Lock(&lock), m_Node(AllocateNode())
+	{
+		try
+		{
+			m_Lock->Enter(*m_Node);
+		}
+		catch(...)
+		{
+			FreeNode(m_Node);
+			throw;
+		}
+	}
+
+	UniqueGuard(UniqueGuard &&rhs) : m_Lock(nullptr), m_Node(nullptr)
+	{
+		std::swap(m_Lock, rhs.m_Lock);
+		std::swap(m_Node, rhs.m_Node);
+	}
+
+	UniqueGuard(const UniqueGuard &) = delete;
+	
+	UniqueGuard &operator=(UniqueGuard &&rhs) noexcept
+	{
+		if(this != &rhs)
+		{
+			std::swap(m_Lock, rhs.m_Lock);
+			std::swap(m_Node, rhs.m_Node);
+		}
+
+		return *this;
+	}
+
+	/**
+	 * Destroys the instance by exitting the lock
+	 */
+	~UniqueGuard() noexcept
+	{
+		if(m_Lock)
+		{
+			m_Lock->Exit(*m_Node);
+			FreeNode(m_Node);
+		}
+	}
+};
+
+using QueueLockGuard = Guard<QueueLock>;
+using QueueLockUniqueGuard = UniqueGuard<QueueLock>;
+
+} // end of namespace
\ No newline at end of file
@@ -52,6 +52,15 @@ public:
 		return ::TryAcquireSRWLockExclusive(&m_Lock)!=FALSE;
 	}
 
+	/**
+	* Attempts to enter the lock in shared mode
+	* @returns true if the lock section was entered, otherwise false
+	*/
+	bool TryEnterShared() noexcept
+	{
+		return ::TryAcquireSRWLockShared(&m_Lock)!=FALSE;
+	}
+
 	/**
 	* Exits a lock that was acquired in exclusive mode
 	*/
@@ -0,0 +1,163 @@
+#pragma once
+
+#include <Echo\WinInclude.h>
+#include <Echo\SpinWait.h>
+
+#include <atomic>
+#include <cstring>
+#include <type_traits>
+
+namespace Echo
+{
+
+/**
+ * A sequence lock protecting a value that is read far more often than it is written.
+ * Readers never write to shared memory. They copy the value and retry if a writer
+ * was active, which they detect from a version counter that is odd during a write.
+ * Writers are serialized against each other using the same counter.
+ *
+ * Because readers may copy a value that is being written, T must be trivially copyable
+ * and readers only ever see a consistent copy, never the shared value itself
+ */
+template<typename T>
+class SeqLock
+{
+	static_assert(std::is_trivially_copyable<T>::value, "SeqLock values must be trivially copyable");
+
+private:
+	std::atomic<size_t> m_Sequence;
+	T m_Value;
+
+	/**
+	 * Makes the sequence odd, waiting for any other writer to finish
+	 * @returns the odd sequence number
+	 */
+	size_t BeginWrite() noexcept
+	{
+		SpinWait spinner;
+		size_t sequence = m_Sequence.load(std::memory_order_relaxed);
+
+		for(;;)
+		{
+			if((sequence & 1) == 0 && m_Sequence.compare_exchange_weak(sequence, sequence + 1, std::memory_order_acquire, std::memory_order_relaxed))
+			{
+				break;
+			}
+
+			spinner.SpinOnce();
+			sequence = m_Sequence.load(std::memory_order_relaxed);
+		}
+
+		// Make sure the odd sequence is visible before any of the writes to the value
+		std::atomic_thread_fence(std::memory_order_release);
+		return sequence + 1;
+	}
+
+	void EndWrite(size_t sequence) noexcept
+	{
+		m_Sequence.store(sequence + 1, std::memory_order_release);
+	}
+
+public:
+	/**
+	 * Initializes the instance with a value initialized T
+	 */
+	SeqLock() : m_Sequence(0), m_Value()
+	{
+	}
+
+	/**
+	 * Initializes the instance
+	 * @param value  the initial value
+	 */
+	explicit SeqLock(const T &value) : m_Sequence(0), m_Value(value)
+	{
+	}
+
+	SeqLock(const SeqLock&) = delete;
+	SeqLock(SeqLock&&) = delete;
+
+	SeqLock &operator=(const SeqLock&) = delete;
+	SeqLock &operator=(SeqLock&&) = delete;
+
+	/**
+	 * Returns a consistent copy of the value
+	 */
+	T Load() const noexcept
+	{
+		SpinWait spinner;
+		T copy;
+
+		for(;;)
+		{
+			size_t before = m_Sequence.load(std::memory_order_acquire);
+
+			if((before & 1) == 0)
+			{
+				std::memcpy(&copy, &m_Value, sizeof(T));
+				std::atomic_thread_fence(std::memory_order_acquire);
+
+				if(m_Sequence.load(std::memory_order_relaxed) == before) return copy;
+			}
+
+			spinner.SpinOnce();
+		}
+	}
+
+	/**
+	 * Calls a function with a consistent copy of the value
+	 * @param function  a function taking a const T&
+	 * @returns whatever the function returns
+	 */
+	template<typename F>
+	auto Read(F function) const -> decltype(function(std::declval<const T&>()))
+	{
+		const T copy = Load();
+		return function(copy);
+	}
+
+	/**
+	 * Replaces the value
+	 * @param value  the new value
+	 */
+	void Store(const T &value) noexcept
+	{
+		size_t sequence = BeginWrite();
+		m_Value = value;
+		EndWrite(sequence);
+	}
+
+	/**
+	 * Calls a function that modifies the value in place.
+	 * Readers spin whilst the function runs, so it should be short
+	 * @param function  a function taking a T&
+	 */
+	template<typename F>
+	void Write(F function)
+	{
+		size_t sequence = BeginWrite();
+
+		try
+		{
+			function(m_Value);
+		}
+		catch(...)
+		{
+			EndWrite(sequence);
+			throw;
+		}
+
+		EndWrite(sequence);
+	}
+
+	/**
+	 * Returns the current version of the value.
+	 * The version changes by two for every write and is odd whilst a write is in progress
+	 */
+	size_t Version() const noexcept
+	{
+		return m_Sequence.load(std::memory_order_acquire);
+	}
+};
+
+} // end of namespace
\ No newline at end of file
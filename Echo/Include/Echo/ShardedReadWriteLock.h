@@ -0,0 +1,364 @@
+#pragma once
+
+#include <Echo\WinInclude.h>
+#include <Echo\Guard.h>
+#include <Echo\CacheLine.h>
+#include <Echo\Environment.h>
+#include <Echo\SpinLock.h>
+#include <Echo\SpinWait.h>
+#include <Echo\AddressWaiter.h>
+
+#include <atomic>
+#include <malloc.h>
+#include <new>
+#include <utility>
+
+namespace Echo
+{
+
+/**
+ * A reader-writer lock with a reader count per processor (a "big reader" lock).
+ * Readers only touch the cache line for the processor they are running on, so shared
+ * acquisitions scale with the number of cores. Writers are expensive as they have to
+ * sweep every processor's slot, so this lock suits data that is very rarely written.
+ *
+ * Readers may migrate between processors whilst holding the lock, so EnterShared returns
+ * the slot that was used and that slot must be passed back to ExitShared
+ */
+class ShardedReadWriteLock
+{
+private:
+	struct alignas(CacheLineSize) Slot
+	{
+		std::atomic<LONG> Readers;
+
+		Slot() noexcept : Readers(0)
+		{
+		}
+	};
+
+	Slot *m_Slots;
+	const DWORD m_SlotCount;
+
+	alignas(CacheLineSize) std::atomic<LONG> m_WriterActive;
+	SpinLock m_WriterLock;
+
+	static Slot *AllocateSlots(DWORD count)
+	{
+		void *memory = ::_aligned_malloc(sizeof(Slot) * count, alignof(Slot));
+		if(memory == nullptr) throw std::bad_alloc();
+
+		Slot *slots = static_cast<Slot*>(memory);
+		for(DWORD i = 0; i < count; i++)
+		{
+			new(&slots[i]) Slot();
+		}
+
+		return slots;
+	}
+
+	size_t CurrentSlot() const noexcept
+	{
+		return ::GetCurrentProcessorNumber() % m_SlotCount;
+	}
+
+	/**
+	 * Registers as a reader, backing out if a writer is active
+	 */
+	bool TryRegisterReader(size_t slot) noexcept
+	{
+		m_Slots[slot].Readers.fetch_add(1, std::memory_order_seq_cst);
+		if(m_WriterActive.load(std::memory_order_seq_cst) == 0) return true;
+
+		UnregisterReader(slot);
+		return false;
+	}
+
+	void UnregisterReader(size_t slot) noexcept
+	{
+		auto &readers = m_Slots[slot].Readers;
+
+		// A writer sweeping the slots may be waiting for this count to reach zero
+		if(readers.fetch_sub(1, std::memory_order_seq_cst) == 1 && m_WriterActive.load(std::memory_order_seq_cst) != 0)
+		{
+			AddressWaiter::WakeAll(readers);
+		}
+	}
+
+	void WaitForWriter()
+	{
+		SpinWait spinner;
+
+		while(m_WriterActive.load(std::memory_order_acquire) != 0)
+		{
+			if(spinner.TotalPauses() < SpinLock::DefaultSpinCount)
+			{
+				spinner.SpinOnce();
+			}
+			else
+			{
+				AddressWaiter::Wait(m_WriterActive, 1L);
+			}
+		}
+	}
+
+	void WaitForReaders(size_t slot)
+	{
+		auto &readers = m_Slots[slot].Readers;
+		SpinWait spinner;
+
+		for(LONG count = readers.load(std::memory_order_seq_cst); count != 0; count = readers.load(std::memory_order_seq_cst))
+		{
+			if(spinner.TotalPauses() < SpinLock::DefaultSpinCount)
+			{
+				spinner.SpinOnce();
+			}
+			else
+			{
+				AddressWaiter::Wait(readers, count);
+			}
+		}
+	}
+
+	bool AnyReaders() const noexcept
+	{
+		for(DWORD i = 0; i < m_SlotCount; i++)
+		{
+			if(m_Slots[i].Readers.load(std::memory_order_seq_cst) != 0) return true;
+		}
+
+		return false;
+	}
+
+	void ReleaseWriter() noexcept
+	{
+		m_WriterActive.store(0, std::memory_order_seq_cst);
+		AddressWaiter::WakeAll(m_WriterActive);
+		m_WriterLock.Exit();
+	}
+
+public:
+	/**
+	 * Initializes the instance with one slot per processor
+	 */
+	ShardedReadWriteLock() : ShardedReadWriteLock(Environment::ProcessorCount())
+	{
+	}
+
+	/**
+	 * Initializes the instance
+	 * @param slotCount  the number of reader slots
+	 */
+	explicit ShardedReadWriteLock(DWORD slotCount) : m_Slots(AllocateSlots(slotCount == 0 ? 1 : slotCount)), m_SlotCount(slotCount == 0 ? 1 : slotCount), m_WriterActive(0)
+	{
+	}
+
+	ShardedReadWriteLock(const ShardedReadWriteLock&) = delete;
+	ShardedReadWriteLock(ShardedReadWriteLock&&) = delete;
+
+	ShardedReadWriteLock &operator=(const ShardedReadWriteLock&) = delete;
+	ShardedReadWriteLock &operator=(ShardedReadWriteLock&&) = delete;
+
+	/**
+	 * Destroys the instance
+	 */
+	~ShardedReadWriteLock()
+	{
+		for(DWORD i = 0; i < m_SlotCount; i++)
+		{
+			m_Slots[i].~Slot();
+		}
+
+		::_aligned_free(m_Slots);
+	}
+
+	/**
+	 * Returns the number of reader slots
+	 */
+	DWORD SlotCount() const noexcept
+	{
+		return m_SlotCount;
+	}
+
+	/**
+	 * Enters the lock in exclusive mode
+	 */
+	void Enter()
+	{
+		m_WriterLock.Enter();
+		m_WriterActive.store(1, std::memory_order_seq_cst);
+
+		for(DWORD i = 0; i < m_SlotCount; i++)
+		{
+			WaitForReaders(i);
+		}
+	}
+
+	/**
+	 * Attempts to enter the lock in exclusive mode without waiting
+	 * @returns true if the lock was entered, otherwise false
+	 */
+	bool TryEnter()
+	{
+		if(m_WriterLock.TryEnter() == false) return false;
+
+		m_WriterActive.store(1, std::memory_order_seq_cst);
+		if(AnyReaders() == false) return true;
+
+		ReleaseWriter();
+		return false;
+	}
+
+	/**
+	 * Exits a lock that was acquired in exclusive mode
+	 */
+	void Exit() noexcept
+	{
+		ReleaseWriter();
+	}
+
+	/**
+	 * Enters the lock in shared mode
+	 * @returns the slot that was used, which must be passed to ExitShared
+	 */
+	size_t EnterShared()
+	{
+		for(;;)
+		{
+			size_t slot = CurrentSlot();
+			if(TryRegisterReader(slot)) return slot;
+
+			WaitForWriter();
+		}
+	}
+
+	/**
+	 * Attempts to enter the lock in shared mode without waiting
+	 * @param slot  receives the slot that was used, which must be passed to ExitShared
+	 * @returns true if the lock was entered, otherwise false
+	 */
+	bool TryEnterShared(size_t &slot) noexcept
+	{
+		slot = CurrentSlot();
+		return TryRegisterReader(slot);
+	}
+
+	/**
+	 * Exits a lock that was acquired in shared mode
+	 * @param slot  the slot returned by EnterShared
+	 */
+	void ExitShared(size_t slot) noexcept
+	{
+		UnregisterReader(slot);
+	}
+};
+
+/**
+ * Locks a sharded read write lock in exclusive mode
+ */
+template<>
+class Guard<ShardedReadWriteLock>
+{
+private:
+	ShardedReadWriteLock &m_Lock;
+
+public:
+	/**
+	 * Exclusively acquires the lock
+	 */
+	explicit Guard(ShardedReadWriteLock &lock) : m_Lock(lock)
+	{
+		m_Lock.Enter();
+	}
+
+	Guard(const Guard &) = delete;
+	Guard(Guard &&) = delete;
+
+	Guard &operator=(Guard &&) = delete;
+	Guard &operator=(const Guard &) = delete;
+
+	/**
+	 * Destroys the instance by releasing the lock
+	 */
+	~Guard() noexcept
+	{
+		m_Lock.Exit();
+	}
+};
+
+/**
+ * Locks a sharded read write lock in shared mode
+ */
+class ShardedReadWriteLockSharedGuard
+{
+private:
+	ShardedReadWriteLock &m_Lock;
+	const size_t m_Slot;
+
+public:
+	/**
+	 * Acquires the lock in shared mode
+	 */
+	explicit ShardedReadWriteLockSharedGuard(ShardedReadWriteLock &lock) : m_Lock(lock), m_Slot(lock.EnterShared())
+	{
+	}
+
+	ShardedReadWriteLockSharedGuard(const ShardedReadWriteLockSharedGuard &) = delete;
+	ShardedReadWriteLockSharedGuard(ShardedReadWriteLockSharedGuard &&) = delete;
+	ShardedReadWriteLockSharedGuard &operator=(const ShardedReadWriteLockSharedGuard &) = delete;
+	ShardedReadWriteLockSharedGuard &operator=(ShardedReadWriteLockSharedGuard &&) = delete;
+
+	/**
+	 * Destroys the instance by releasing the shared lock
+	 */
+	~ShardedReadWriteLockSharedGuard() noexcept
+	{
+		m_Lock.ExitShared(m_Slot);
+	}
+};
+
+template<>
+class UniqueGuard<ShardedReadWriteLock>
+{
+private:
+	ShardedReadWriteLock *m_Lock;
+
+public:
+	/**
+	 * Exclusively acquires the lock
+	 */
+	explicit UniqueGuard(ShardedReadWriteLock &lock) : m_Lock(&lock)
+	{
+		m_Lock->Enter();
+	}
+
+	UniqueGuard(UniqueGuard &&rhs) : m_Lock(nullptr)
+	{
+		std::swap(m_Lock, rhs.m_Lock);
+	}
+
+	UniqueGuard(const UniqueGuard &) = delete;
+
+	UniqueGuard &operator=(UniqueGuard &&rhs) noexcept
+	{
+		if(this != &rhs)
+		{
+			std::swap(m_Lock, rhs.m_Lock);
+		}
+
+		return *this;
+	}
+
+	/**
+	 * Destroys the instance by releasing the lock
+	 */
+	~UniqueGuard() noexcept
+	{
+		if(m_Lock) m_Lock->Exit();
+	}
+};
+
+using ShardedReadWriteLockGuard = Guard<ShardedReadWriteLock>;
+using ShardedReadWriteLockUniqueGuard = UniqueGuard<ShardedReadWriteLock>;
+
+} // end of namespace
\ No newline at end of file
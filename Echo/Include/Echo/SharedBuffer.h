@@ -0,0 +1,269 @@
+#pragma once
+
+#include <Echo\WinInclude.h>
+#include <Echo\Buffer.h>
+#include <Echo\Exceptions.h>
+
+#include <atomic>
+#include <cstdint>
+#include <utility>
+
+namespace Echo
+{
+
+class BufferSlice;
+
+/**
+ * A read-only, reference counted Buffer that can be shared between threads without copying.
+ * A Buffer is filled in whilst it is still uniquely owned and then moved into a SharedBuffer,
+ * after which only const access is possible, so the contents can be read concurrently.
+ *
+ * Copying a SharedBuffer just increments an atomic count. The buffer, wherever it came from,
+ * is released when the last SharedBuffer or BufferSlice referring to it goes away
+ */
+class SharedBuffer
+{
+private:
+	struct Block
+	{
+		std::atomic<LONG> References;
+		Buffer Storage;
+
+		explicit Block(Buffer &&storage) : References(1), Storage(std::move(storage))
+		{
+		}
+	};
+
+	Block *m_Block;
+
+	void AddReference() const noexcept
+	{
+		if(m_Block != nullptr) m_Block->References.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	void RemoveReference() noexcept
+	{
+		// The release/acquire pair makes every other owner's reads happen before the delete
+		if(m_Block != nullptr && m_Block->References.fetch_sub(1, std::memory_order_acq_rel) == 1)
+		{
+			delete m_Block;
+		}
+
+		m_Block = nullptr;
+	}
+
+public:
+	/**
+	 * Initializes an empty instance
+	 */
+	SharedBuffer() noexcept : m_Block(nullptr)
+	{
+	}
+
+	/**
+	 * Initializes the instance by taking ownership of a buffer
+	 * @param buffer  the buffer to share
+	 */
+	explicit SharedBuffer(Buffer &&buffer) : m_Block(new Block(std::move(buffer)))
+	{
+	}
+
+	SharedBuffer(const SharedBuffer &rhs) noexcept : m_Block(rhs.m_Block)
+	{
+		AddReference();
+	}
+
+	SharedBuffer(SharedBuffer &&rhs) noexcept : m_Block(rhs.m_Block)
+	{
+		rhs.m_Block = nullptr;
+	}
+
+	~SharedBuffer()
+	{
+		RemoveReference();
+	}
+
+	SharedBuffer &operator=(const SharedBuffer &rhs) noexcept
+	{
+		if(m_Block != rhs.m_Block)
+		{
+			rhs.AddReference();
+			RemoveReference();
+
+			m_Block = rhs.m_Block;
+		}
+
+		return *this;
+	}
+
+	SharedBuffer &operator=(SharedBuffer &&rhs) noexcept
+	{
+		if(this != &rhs)
+		{
+			RemoveReference();
+			std::swap(m_Block, rhs.m_Block);
+		}
+
+		return *this;
+	}
+
+	/**
+	 * Indicates if the instance refers to a buffer
+	 */
+	explicit operator bool() const noexcept
+	{
+		return m_Block != nullptr;
+	}
+
+	/**
+	 * Returns the number of SharedBuffers and BufferSlices referring to the buffer.
+	 * Only a snapshot if other threads hold references
+	 */
+	LONG ReferenceCount() const noexcept
+	{
+		return (m_Block == nullptr ? 0 : m_Block->References.load(std::memory_order_relaxed));
+	}
+
+	/**
+	 * Returns the size of the buffer, in bytes
+	 */
+	size_t Size() const noexcept
+	{
+		return (m_Block == nullptr ? 0 : m_Block->Storage.Size());
+	}
+
+	/**
+	 * Returns a pointer to the buffer
+	 */
+	const void *Data() const noexcept
+	{
+		return (m_Block == nullptr ? nullptr : m_Block->Storage.Data());
+	}
+
+	/**
+	 * Returns a pointer to the buffer as a specified type
+	 */
+	template<typename T>
+	const T *DataAs() const noexcept
+	{
+		return static_cast<const T*>(Data());
+	}
+
+	/**
+	 * Returns a slice of the whole buffer
+	 */
+	BufferSlice Slice() const;
+
+	/**
+	 * Returns a slice of part of the buffer, sharing it rather than copying
+	 * @param offset  the offset of the slice, in bytes
+	 * @param length  the length of the slice, in bytes
+	 */
+	BufferSlice Slice(size_t offset, size_t length) const;
+};
+
+/**
+ * A read-only window onto part of a SharedBuffer.
+ * The slice keeps the whole buffer alive, so slices can be handed to other threads
+ * (for example through a WorkDispatchQueue) and sliced again without copying
+ */
+class BufferSlice
+{
+private:
+	SharedBuffer m_Buffer;
+	size_t m_Offset;
+	size_t m_Length;
+
+public:
+	/**
+	 * Initializes an empty instance
+	 */
+	BufferSlice() noexcept : m_Offset(0), m_Length(0)
+	{
+	}
+
+	/**
+	 * Initializes the instance
+	 * @param buffer  the buffer to refer to
+	 * @param offset  the offset of the slice, in bytes
+	 * @param length  the length of the slice, in bytes
+	 */
+	BufferSlice(const SharedBuffer &buffer, size_t offset, size_t length) : m_Buffer(buffer), m_Offset(offset), m_Length(length)
+	{
+		if(offset > buffer.Size() || length > buffer.Size() - offset) throw ArgumentException(_T("slice is outside the buffer"));
+	}
+
+	/**
+	 * Returns the buffer the slice refers to
+	 */
+	const SharedBuffer &Source() const noexcept
+	{
+		return m_Buffer;
+	}
+
+	/**
+	 * Returns the offset of the slice within the buffer, in bytes
+	 */
+	size_t Offset() const noexcept
+	{
+		return m_Offset;
+	}
+
+	/**
+	 * Returns the length of the slice, in bytes
+	 */
+	size_t Size() const noexcept
+	{
+		return m_Length;
+	}
+
+	/**
+	 * Indicates if the slice is empty
+	 */
+	bool IsEmpty() const noexcept
+	{
+		return m_Length == 0;
+	}
+
+	/**
+	 * Returns a pointer to the start of the slice
+	 */
+	const void *Data() const noexcept
+	{
+		return DataAs<std::uint8_t>();
+	}
+
+	/**
+	 * Returns a pointer to the start of the slice as a specified type
+	 */
+	template<typename T>
+	const T *DataAs() const noexcept
+	{
+		auto start = m_Buffer.DataAs<std::uint8_t>();
+		return reinterpret_cast<const T*>(start == nullptr ? nullptr : start + m_Offset);
+	}
+
+	/**
+	 * Returns part of this slice, sharing the buffer rather than copying
+	 * @param offset  the offset within this slice, in bytes
+	 * @param length  the length of the new slice, in bytes
+	 */
+	BufferSlice Slice(size_t offset, size_t length) const
+	{
+		if(offset > m_Length || length > m_Length - offset) throw ArgumentException(_T("slice is outside the slice"));
+
+		return BufferSlice(m_Buffer, m_Offset + offset, length);
+	}
+};
+
+inline BufferSlice SharedBuffer::Slice() const
+{
+	return BufferSlice(*this, 0, Size());
+}
+
+inline BufferSlice SharedBuffer::Slice(size_t offset, size_t length) const
+{
+	return BufferSlice(*this, offset, length);
+}
+
+} // end of namespace
\ No newline at end of file
@@ -0,0 +1,461 @@
+#pragma once
+
+#include <Echo\WinInclude.h>
+#include <Echo\Guard.h>
+#include <Echo\Exceptions.h>
+#include <Echo\CriticalSection.h>
+
+#include <malloc.h>
+
+#include <atomic>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+
+namespace Echo
+{
+
+/**
+ * A pool of fixed size, aligned slots of raw storage, carved from slabs allocated on the heap.
+ *
+ * Each thread keeps a couple of small magazines of free slots for each pool it uses, so in the
+ * steady state Allocate and Free just pop and push a thread local array. When a thread runs dry
+ * (or fills up) it swaps a whole magazine with the pool's depot, which is a pair of lock-free
+ * Win32 SLISTs. Only growing the pool touches the global allocator.
+ *
+ * Magazines and slabs are sized in bytes as well as slots, so a pool of large buffers grows a few
+ * buffers at a time and a thread never hoards more than a couple of slabs' worth of them.
+ *
+ * A slot freed on another thread goes into that thread's magazine for the same pool and
+ * reaches the depot with the rest of the magazine, so storage always returns to the pool it came from.
+ *
+ * The pool must outlive the slots it hands out. Storage held in a thread's magazines is released
+ * when the thread exits or next misses in its cache after the pool has been destroyed
+ */
+class SlabPool
+{
+private:
+	/**
+	 * The most slots a magazine can hold, which is what small slots get
+	 */
+	static const size_t MaximumMagazineSize = 32;
+
+	/**
+	 * Large slots get fewer per magazine, so that a magazine (and a slab) covers about this many bytes
+	 */
+	static const size_t MagazineBytes = 64 * 1024;
+
+	struct Magazine
+	{
+		SLIST_ENTRY Entry;
+		size_t Count;
+		void *Items[MaximumMagazineSize];
+	};
+
+	/**
+	 * The state shared by the pool and every thread that has cached slots from it
+	 */
+	class Depot
+	{
+	private:
+		SLIST_HEADER m_Full;
+		SLIST_HEADER m_Empty;
+
+		const size_t m_SlotSize;
+		const size_t m_Alignment;
+		const size_t m_MagazineSize;
+
+		CriticalSection m_SyncRoot;
+		std::vector<void*> m_Slabs;
+
+		std::atomic<size_t> m_Capacity;
+		std::atomic<bool> m_Closed;
+
+		static Magazine *Pop(SLIST_HEADER &list) noexcept
+		{
+			auto entry = ::InterlockedPopEntrySList(&list);
+			return (entry == nullptr ? nullptr : CONTAINING_RECORD(entry, Magazine, Entry));
+		}
+
+		static void FreeAll(SLIST_HEADER &list) noexcept
+		{
+			while(auto magazine = Pop(list))
+			{
+				::_aligned_free(magazine);
+			}
+		}
+
+	public:
+		Depot(size_t slotSize, size_t alignment, size_t magazineSize) : m_SlotSize(slotSize), m_Alignment(alignment), m_MagazineSize(magazineSize), m_Capacity(0), m_Closed(false)
+		{
+			::InitializeSListHead(&m_Full);
+			::InitializeSListHead(&m_Empty);
+		}
+
+		~Depot()
+		{
+			FreeAll(m_Full);
+			FreeAll(m_Empty);
+
+			for(auto slab : m_Slabs)
+			{
+				::_aligned_free(slab);
+			}
+		}
+
+		Depot(const Depot&) = delete;
+		Depot &operator=(const Depot&) = delete;
+
+		size_t Capacity() const noexcept
+		{
+			return m_Capacity.load(std::memory_order_relaxed);
+		}
+
+		bool IsClosed() const noexcept
+		{
+			return m_Closed.load(std::memory_order_acquire);
+		}
+
+		void Close() noexcept
+		{
+			m_Closed.store(true, std::memory_order_release);
+		}
+
+		Magazine *PopFull() noexcept
+		{
+			return Pop(m_Full);
+		}
+
+		/**
+		 * Returns an empty magazine, allocating one if the depot has none spare
+		 * @returns the magazine, or null if one couldn't be allocated
+		 */
+		Magazine *PopEmpty() noexcept
+		{
+			auto magazine = Pop(m_Empty);
+
+			if(magazine == nullptr)
+			{
+				magazine = static_cast<Magazine*>(::_aligned_malloc(sizeof(Magazine), MEMORY_ALLOCATION_ALIGNMENT));
+				if(magazine == nullptr) return nullptr;
+			}
+
+			magazine->Count = 0;
+			return magazine;
+		}
+
+		/**
+		 * Hands a magazine back, sorting it by whether it holds anything
+		 */
+		void Push(Magazine *magazine) noexcept
+		{
+			::InterlockedPushEntrySList(magazine->Count == 0 ? &m_Empty : &m_Full, &magazine->Entry);
+		}
+
+		/**
+		 * Allocates a slab of one magazine's worth of slots from the heap
+		 * @returns a full magazine holding the slots of the new slab
+		 */
+		Magazine *Grow()
+		{
+			auto magazine = PopEmpty();
+			if(magazine == nullptr) throw std::bad_alloc();
+
+			auto slab = static_cast<char*>(::_aligned_malloc(m_SlotSize * m_MagazineSize, m_Alignment));
+			if(slab == nullptr)
+			{
+				Push(magazine);
+				throw std::bad_alloc();
+			}
+
+			try
+			{
+				Guard<CriticalSection> lock(m_SyncRoot);
+				m_Slabs.push_back(slab);
+			}
+			catch(...)
+			{
+				::_aligned_free(slab);
+				Push(magazine);
+				throw;
+			}
+
+			for(size_t i = 0; i < m_MagazineSize; i++)
+			{
+				magazine->Items[i] = slab + (i * m_SlotSize);
+			}
+
+			magazine->Count = m_MagazineSize;
+			m_Capacity.fetch_add(m_MagazineSize, std::memory_order_relaxed);
+
+			return magazine;
+		}
+	};
+
+	/**
+	 * A thread's magazines for one pool
+	 */
+	struct CacheEntry
+	{
+		std::shared_ptr<Depot> Owner;
+		Magazine *Loaded;
+		Magazine *Previous;
+	};
+
+	/**
+	 * Every magazine the calling thread holds.
+	 * A thread rarely uses more than a handful of pools, so a vector remembering the last hit is enough
+	 */
+	class ThreadCache
+	{
+	private:
+		std::vector<CacheEntry> m_Entries;
+		size_t m_Last;
+
+		static void Flush(CacheEntry &entry) noexcept
+		{
+			if(entry.Loaded != nullptr) entry.Owner->Push(entry.Loaded);
+			if(entry.Previous != nullptr) entry.Owner->Push(entry.Previous);
+		}
+
+		/**
+		 * Gives back the magazines of any pools that have been destroyed
+		 */
+		void Prune() noexcept
+		{
+			for(size_t i = m_Entries.size(); i-- > 0; )
+			{
+				if(m_Entries[i].Owner->IsClosed())
+				{
+					Flush(m_Entries[i]);
+					m_Entries.erase(m_Entries.begin() + i);
+				}
+			}
+
+			m_Last = 0;
+		}
+
+		/**
+		 * Finds the calling thread's entry for a pool, adding one on first use
+		 */
+		CacheEntry *Lookup(const std::shared_ptr<Depot> &depot) noexcept
+		{
+			if(m_Last < m_Entries.size() && m_Entries[m_Last].Owner == depot) return &m_Entries[m_Last];
+
+			Prune();
+
+			for(size_t i = 0; i < m_Entries.size(); i++)
+			{
+				if(m_Entries[i].Owner == depot)
+				{
+					m_Last = i;
+					return &m_Entries[i];
+				}
+			}
+
+			// Find fills in the magazines
+			CacheEntry entry = {depot, nullptr, nullptr};
+
+			try
+			{
+				m_Entries.push_back(entry);
+			}
+			catch(...)
+			{
+				Flush(entry);
+				return nullptr;
+			}
+
+			m_Last = m_Entries.size() - 1;
+			return &m_Entries[m_Last];
+		}
+
+	public:
+		ThreadCache() : m_Last(0)
+		{
+		}
+
+		~ThreadCache()
+		{
+			for(auto &entry : m_Entries)
+			{
+				Flush(entry);
+			}
+		}
+
+		ThreadCache(const ThreadCache&) = delete;
+		ThreadCache &operator=(const ThreadCache&) = delete;
+
+		/**
+		 * Returns the calling thread's magazines for a pool, creating them on first use.
+		 * A magazine that couldn't be allocated before is tried for again, so running out of memory once doesn't
+		 * leave the pool unusable on this thread
+		 * @returns the entry, which may still be missing magazines, or null if it couldn't be created
+		 */
+		CacheEntry *Find(const std::shared_ptr<Depot> &depot) noexcept
+		{
+			auto entry = Lookup(depot);
+			if(entry == nullptr) return nullptr;
+
+			if(entry->Loaded == nullptr) entry->Loaded = depot->PopEmpty();
+			if(entry->Previous == nullptr) entry->Previous = depot->PopEmpty();
+
+			return entry;
+		}
+	};
+
+	const size_t m_SlotSize;
+	const size_t m_Alignment;
+	const size_t m_MagazineSize;
+	std::shared_ptr<Depot> m_Depot;
+
+	static ThreadCache &CurrentThreadCache()
+	{
+		static thread_local ThreadCache cache;
+		return cache;
+	}
+
+	static size_t RoundUp(size_t value, size_t alignment) noexcept
+	{
+		return (value + alignment - 1) & ~(alignment - 1);
+	}
+
+	static size_t MagazineSizeFor(size_t slotSize) noexcept
+	{
+		size_t slots = (slotSize == 0 ? MaximumMagazineSize : MagazineBytes / slotSize);
+		if(slots == 0) return 1;
+
+		return (slots < MaximumMagazineSize ? slots : MaximumMagazineSize);
+	}
+
+public:
+	/**
+	 * Initializes the instance
+	 * @param slotSize  the size of each slot, in bytes. It is rounded up to a multiple of the alignment
+	 * @param alignment  the alignment of each slot, which must be a power of two
+	 * @param preallocate  the number of slots to allocate up front
+	 */
+	SlabPool(size_t slotSize, size_t alignment, size_t preallocate = 0) : m_SlotSize(RoundUp(slotSize, alignment)), m_Alignment(alignment), m_MagazineSize(MagazineSizeFor(m_SlotSize))
+	{
+		if(slotSize == 0) throw ArgumentException(_T("slotSize must be greater than zero"));
+		if(alignment == 0 || (alignment & (alignment - 1)) != 0) throw ArgumentException(_T("alignment must be a power of two"));
+
+		m_Depot = std::make_shared<Depot>(m_SlotSize, m_Alignment, m_MagazineSize);
+		Reserve(preallocate);
+	}
+
+	~SlabPool()
+	{
+		m_Depot->Close();
+	}
+
+	SlabPool(const SlabPool&) = delete;
+	SlabPool(SlabPool&&) = delete;
+
+	SlabPool &operator=(const SlabPool&) = delete;
+	SlabPool &operator=(SlabPool&&) = delete;
+
+	/**
+	 * Returns the size of each slot, in bytes
+	 */
+	size_t SlotSize() const noexcept
+	{
+		return m_SlotSize;
+	}
+
+	/**
+	 * Returns the alignment of each slot
+	 */
+	size_t Alignment() const noexcept
+	{
+		return m_Alignment;
+	}
+
+	/**
+	 * Returns the number of slots in each slab, which is also how many a magazine holds
+	 */
+	size_t SlabSize() const noexcept
+	{
+		return m_MagazineSize;
+	}
+
+	/**
+	 * Returns the number of slots the pool has allocated from the heap
+	 */
+	size_t Capacity() const noexcept
+	{
+		return m_Depot->Capacity();
+	}
+
+	/**
+	 * Allocates at least count more slots and places them in the depot
+	 * @param count  the number of slots
+	 */
+	void Reserve(size_t count)
+	{
+		for(size_t reserved = 0; reserved < count; reserved += m_MagazineSize)
+		{
+			m_Depot->Push(m_Depot->Grow());
+		}
+	}
+
+	/**
+	 * Takes a slot from the pool
+	 */
+	void *Allocate()
+	{
+		auto entry = CurrentThreadCache().Find(m_Depot);
+		if(entry == nullptr || entry->Loaded == nullptr || entry->Previous == nullptr) throw std::bad_alloc();
+
+		if(entry->Loaded->Count == 0)
+		{
+			if(entry->Previous->Count != 0)
+			{
+				std::swap(entry->Loaded, entry->Previous);
+			}
+			else
+			{
+				auto full = m_Depot->PopFull();
+				if(full == nullptr) full = m_Depot->Grow();
+
+				m_Depot->Push(entry->Previous);
+				entry->Previous = entry->Loaded;
+				entry->Loaded = full;
+			}
+		}
+
+		return entry->Loaded->Items[--entry->Loaded->Count];
+	}
+
+	/**
+	 * Returns a slot to the calling thread's magazines.
+	 * If no magazine can be found for it the slot simply isn't reused, but is still released with the pool
+	 */
+	void Free(void *slot) noexcept
+	{
+		auto entry = CurrentThreadCache().Find(m_Depot);
+		if(entry == nullptr || entry->Loaded == nullptr || entry->Previous == nullptr) return;
+
+		if(entry->Loaded->Count == m_MagazineSize)
+		{
+			if(entry->Previous->Count == 0)
+			{
+				std::swap(entry->Loaded, entry->Previous);
+			}
+			else
+			{
+				auto empty = m_Depot->PopEmpty();
+				if(empty == nullptr) return;
+
+				m_Depot->Push(entry->Previous);
+				entry->Previous = entry->Loaded;
+				entry->Loaded = empty;
+			}
+		}
+
+		entry->Loaded->Items[entry->Loaded->Count++] = slot;
+	}
+};
+
+} // end of namespace
\ No newline at end of file
@@ -0,0 +1,260 @@
+#pragma once
+
+#include <Echo\WinInclude.h>
+#include <Echo\Guard.h>
+#include <Echo\SpinWait.h>
+#include <Echo\AddressWaiter.h>
+
+#include <atomic>
+#include <utility>
+
+namespace Echo
+{
+
+/**
+ * An adaptive lock for very short critical sections.
+ * A contended Enter spins with exponential backoff for up to a tunable budget,
+ * watching the lock with plain reads, and only then parks the thread with WaitOnAddress.
+ * An uncontended Enter or Exit never leaves user mode
+ */
+class SpinLock
+{
+private:
+	enum : LONG
+	{
+		Unlocked = 0,
+		Locked = 1,
+		LockedWithWaiters = 2
+	};
+
+	std::atomic<LONG> m_State;
+	const unsigned m_SpinCount;
+
+	bool TryAcquire() noexcept
+	{
+		LONG expected = Unlocked;
+		return m_State.compare_exchange_strong(expected, Locked, std::memory_order_acquire, std::memory_order_relaxed);
+	}
+
+	void EnterContended()
+	{
+		SpinWait spinner;
+
+		// Test-and-test-and-set: only attempt the write when the lock looks free
+		while(spinner.TotalPauses() < m_SpinCount)
+		{
+			if(m_State.load(std::memory_order_relaxed) == Unlocked && TryAcquire()) return;
+			spinner.SpinOnce();
+		}
+
+		// Out of budget, so advertise that we're waiting and park until the owner hands over
+		while(m_State.exchange(LockedWithWaiters, std::memory_order_acquire) != Unlocked)
+		{
+			AddressWaiter::Wait(m_State, static_cast<LONG>(LockedWithWaiters));
+		}
+	}
+
+public:
+	/**
+	 * The default number of pause instructions to spin for before parking
+	 */
+	static const unsigned DefaultSpinCount = 4000;
+
+	/**
+	 * Initializes the instance
+	 * @param spinCount  how many pause instructions to spin for before parking the thread
+	 */
+	explicit SpinLock(unsigned spinCount = DefaultSpinCount) noexcept : m_State(Unlocked), m_SpinCount(spinCount)
+	{
+	}
+
+	SpinLock(const SpinLock&) = delete;
+	SpinLock(SpinLock&&) = delete;
+
+	SpinLock &operator=(const SpinLock&) = delete;
+	SpinLock &operator=(SpinLock&&) = delete;
+
+	/**
+	 * Enters the lock
+	 */
+	void Enter()
+	{
+		if(TryAcquire()) return;
+		EnterContended();
+	}
+
+	/**
+	 * Attempts to enter the lock without waiting
+	 * @returns true if the lock was entered, otherwise false
+	 */
+	bool TryEnter() noexcept
+	{
+		return m_State.load(std::memory_order_relaxed) == Unlocked && TryAcquire();
+	}
+
+	/**
+	 * Exits the lock, waking a parked thread if there is one
+	 */
+	void Exit() noexcept
+	{
+		if(m_State.exchange(Unlocked, std::memory_order_release) == LockedWithWaiters)
+		{
+			AddressWaiter::WakeOne(m_State);
+		}
+	}
+
+	/**
+	 * Returns how many pause instructions a contended Enter spins for before parking
+	 */
+	unsigned SpinCount() const noexcept
+	{
+		return m_SpinCount;
+	}
+};
+
+/**
+ * Locks a spin lock
+ */
+template<>
+class Guard<SpinLock>
+{
+private:
+	SpinLock &m_Lock;
+
+public:
+	/**
+	 * Initializes the instance by entering the lock
+	 */
+	explicit Guard(SpinLock &lock) : m_Lock(lock)
+	{
+		m_Lock.Enter();
+	}
+
+	Guard(const Guard &) = delete;
+	Guard &operator=(const Guard &) = delete;
+	Guard &operator=(Guard &&) = delete;
+
+	/**
+	 * Destroys the instance by exitting the lock
+	 */
+	~Guard() noexcept
+	{
+		m_Lock.Exit();
+	}
+};
+
+/**
+ * Unlocks a spin lock
+ */
+template<>
+class Unguard<SpinLock>
+{
+private:
+	SpinLock &m_Lock;
+
+public:
+	/**
+	 * Initializes the instance by exitting the lock
+	 */
+	Unguard(SpinLock &lock) : m_Lock(lock)
+	{
+		m_Lock.Exit();
+	}
+
+	Unguard(const Unguard &) = delete;
+	Unguard &operator=(const Unguard &) = delete;
+	Unguard &operator=(Unguard &&) = delete;
+
+	/**
+	 * Destroys the instance by entering the lock
+	 */
+	~Unguard()
+	{
+		m_Lock.Enter();
+	}
+};
+
+template<>
+class TryGuard<SpinLock>
+{
+private:
+	SpinLock &m_Lock;
+	const bool m_Locked;
+
+public:
+	/**
+	 * Initializes the instance by attempting to enter the lock
+	 */
+	TryGuard(SpinLock &lock) : m_Lock(lock), m_Locked(lock.TryEnter())
+	{
+	}
+
+	TryGuard(const TryGuard &) = delete;
+	TryGuard &operator=(const TryGuard &) = delete;
+	TryGuard &operator=(TryGuard &&) = delete;
+
+	/**
+	 * Inidicates if the lock was entered
+	 */
+	bool IsLocked() const
+	{
+		return m_Locked;
+	}
+
+	/**
+	 * Destroys the instance exitting the lock if it was entered
+	 */
+	~TryGuard()
+	{
+		if(m_Locked)
+		{
+			m_Lock.Exit();
+		}
+	}
+};
+
+template<>
+class UniqueGuard<SpinLock>
+{
+private:
+	SpinLock *m_Lock;
+
+public:
+	/**
+	 * Initializes the instance by entering the lock
+	 */
+	explicit UniqueGuard(SpinLock &lock) : m_Lock(&lock)
+	{
+		m_Lock->Enter();
+	}
+
+	UniqueGuard(UniqueGuard &&rhs) : m_Lock(nullptr)
+	{
+		std::swap(m_Lock, rhs.m_Lock);
+	}
+
+	UniqueGuard(const UniqueGuard &) = delete;
+	
+	UniqueGuard &operator=(UniqueGuard &&rhs) noexcept
+	{
+		if(this != &rhs)
+		{
+			std::swap(m_Lock, rhs.m_Lock);
+		}
+
+		return *this;
+	}
+
+	/**
+	 * Destroys the instance by exitting the lock
+	 */
+	~UniqueGuard() noexcept
+	{
+		if(m_Lock) m_Lock->Exit();
+	}
+};
+
+using SpinLockGuard = Guard<SpinLock>;
+using SpinLockUniqueGuard = UniqueGuard<SpinLock>;
+
+} // end of namespace
\ No newline at end of file
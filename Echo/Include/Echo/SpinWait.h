@@ -0,0 +1,64 @@
+#pragma once
+
+#include <Echo\WinInclude.h>
+
+namespace Echo
+{
+
+/**
+ * Spins with exponential backoff.
+ * Each call to SpinOnce issues twice as many pause instructions as the last,
+ * up to a limit, which keeps a spinning thread from hammering a contended cache line
+ */
+class SpinWait
+{
+private:
+	unsigned m_Pauses = 1;
+	unsigned m_TotalPauses = 0;
+	const unsigned m_MaximumPauses;
+
+public:
+	/**
+	 * Initializes the instance
+	 * @param maximumPauses  the most pause instructions a single SpinOnce will issue
+	 */
+	explicit SpinWait(unsigned maximumPauses = 64) noexcept : m_MaximumPauses(maximumPauses)
+	{
+	}
+
+	SpinWait(const SpinWait&) = delete;
+	SpinWait &operator=(const SpinWait&) = delete;
+
+	/**
+	 * Spins for the current backoff period and then doubles it
+	 */
+	void SpinOnce() noexcept
+	{
+		for(unsigned i = 0; i < m_Pauses; i++)
+		{
+			YieldProcessor();
+		}
+
+		m_TotalPauses += m_Pauses;
+		if(m_Pauses < m_MaximumPauses) m_Pauses <<= 1;
+	}
+
+	/**
+	 * Returns the total number of pause instructions issued so far
+	 */
+	unsigned TotalPauses() const noexcept
+	{
+		return m_TotalPauses;
+	}
+
+	/**
+	 * Resets the backoff to its initial state
+	 */
+	void Reset() noexcept
+	{
+		m_Pauses = 1;
+		m_TotalPauses = 0;
+	}
+};
+
+} // end of namespace
\ No newline at end of file
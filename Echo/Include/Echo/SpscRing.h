@@ -0,0 +1,251 @@
+#pragma once
+
+#include <Echo\WinInclude.h>
+#include <Echo\CacheLine.h>
+#include <Echo\Exceptions.h>
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <utility>
+
+namespace Echo
+{
+
+/**
+ * A bounded, lock-free ring for handing items from exactly one producer thread
+ * to exactly one consumer thread.
+ *
+ * The producer and consumer indexes live on separate cache lines, and each side keeps
+ * a private copy of the other side's index so it only touches the shared line when
+ * its copy says the ring is full (or empty).
+ *
+ * Every slot holds a live T for the lifetime of the ring, which allows slots to be
+ * claimed, filled in place and then committed without copying
+ */
+template<typename T>
+class SpscRing
+{
+private:
+	std::unique_ptr<T[]> m_Slots;
+	const size_t m_Capacity;
+	const size_t m_Mask;
+
+	// Written by the producer
+	alignas(CacheLineSize) std::atomic<size_t> m_Tail;
+	size_t m_CachedHead;
+
+	// Written by the consumer
+	alignas(CacheLineSize) std::atomic<size_t> m_Head;
+	size_t m_CachedTail;
+
+	static size_t RoundUpToPowerOfTwo(size_t value)
+	{
+		size_t capacity = 1;
+		while(capacity < value) capacity <<= 1;
+
+		return capacity;
+	}
+
+	/**
+	 * Returns how many slots the producer can fill, refreshing its copy of the head if it looks short
+	 */
+	size_t FreeSlots(size_t tail, size_t wanted) noexcept
+	{
+		size_t free = m_Capacity - (tail - m_CachedHead);
+
+		if(free < wanted)
+		{
+			m_CachedHead = m_Head.load(std::memory_order_acquire);
+			free = m_Capacity - (tail - m_CachedHead);
+		}
+
+		return free;
+	}
+
+	/**
+	 * Returns how many items the consumer can take, refreshing its copy of the tail if it looks short
+	 */
+	size_t AvailableItems(size_t head, size_t wanted) noexcept
+	{
+		size_t available = m_CachedTail - head;
+
+		if(available < wanted)
+		{
+			m_CachedTail = m_Tail.load(std::memory_order_acquire);
+			available = m_CachedTail - head;
+		}
+
+		return available;
+	}
+
+public:
+	/**
+	 * Initializes the instance
+	 * @param capacity  the minimum number of items the ring can hold. It is rounded up to a power of two
+	 */
+	explicit SpscRing(size_t capacity) : m_Capacity(RoundUpToPowerOfTwo(capacity)), m_Mask(m_Capacity - 1), m_Tail(0), m_CachedHead(0), m_Head(0), m_CachedTail(0)
+	{
+		if(capacity == 0) throw ArgumentException(_T("capacity must be greater than zero"));
+
+		m_Slots.reset(new T[m_Capacity]);
+	}
+
+	SpscRing(const SpscRing&) = delete;
+	SpscRing(SpscRing&&) = delete;
+
+	SpscRing &operator=(const SpscRing&) = delete;
+	SpscRing &operator=(SpscRing&&) = delete;
+
+	/**
+	 * Returns the number of items the ring can hold
+	 */
+	size_t Capacity() const noexcept
+	{
+		return m_Capacity;
+	}
+
+	/**
+	 * Returns the number of items in the ring.
+	 * Only a snapshot if called whilst the other thread is active
+	 */
+	size_t Size() const noexcept
+	{
+		size_t head = m_Head.load(std::memory_order_acquire);
+		size_t tail = m_Tail.load(std::memory_order_acquire);
+
+		return tail - head;
+	}
+
+	/**
+	 * Indicates if the ring is empty. Only a snapshot if called whilst the other thread is active
+	 */
+	bool IsEmpty() const noexcept
+	{
+		return Size() == 0;
+	}
+
+	/**
+	 * Adds an item to the ring. Producer only
+	 * @returns true if the item was added, false if the ring is full
+	 */
+	template<typename U>
+	bool TryPush(U &&item)
+	{
+		size_t tail = m_Tail.load(std::memory_order_relaxed);
+		if(FreeSlots(tail, 1) == 0) return false;
+
+		m_Slots[tail & m_Mask] = std::forward<U>(item);
+		m_Tail.store(tail + 1, std::memory_order_release);
+
+		return true;
+	}
+
+	/**
+	 * Adds as many items as will fit, publishing them to the consumer in one go. Producer only
+	 * @param items  the items to add
+	 * @param count  the number of items
+	 * @returns the number of items added
+	 */
+	size_t TryPushN(const T *items, size_t count)
+	{
+		size_t tail = m_Tail.load(std::memory_order_relaxed);
+		size_t pushed = (std::min)(count, FreeSlots(tail, count));
+
+		for(size_t i = 0; i < pushed; i++)
+		{
+			m_Slots[(tail + i) & m_Mask] = items[i];
+		}
+
+		if(pushed != 0) m_Tail.store(tail + pushed, std::memory_order_release);
+		return pushed;
+	}
+
+	/**
+	 * Removes an item from the ring. Consumer only
+	 * @param item  receives the item
+	 * @returns true if an item was removed, false if the ring is empty
+	 */
+	bool TryPop(T &item)
+	{
+		size_t head = m_Head.load(std::memory_order_relaxed);
+		if(AvailableItems(head, 1) == 0) return false;
+
+		item = std::move(m_Slots[head & m_Mask]);
+		m_Head.store(head + 1, std::memory_order_release);
+
+		return true;
+	}
+
+	/**
+	 * Removes up to count items, returning the slots to the producer in one go. Consumer only
+	 * @param items  receives the items
+	 * @param count  the maximum number of items to remove
+	 * @returns the number of items removed
+	 */
+	size_t TryPopN(T *items, size_t count)
+	{
+		size_t head = m_Head.load(std::memory_order_relaxed);
+		size_t popped = (std::min)(count, AvailableItems(head, count));
+
+		for(size_t i = 0; i < popped; i++)
+		{
+			items[i] = std::move(m_Slots[(head + i) & m_Mask]);
+		}
+
+		if(popped != 0) m_Head.store(head + popped, std::memory_order_release);
+		return popped;
+	}
+
+	/**
+	 * Claims contiguous free slots so they can be filled in place. Producer only.
+	 * Fewer slots than wanted may be claimed if the ring is nearly full or the slots wrap around
+	 * @param wanted  the number of slots wanted
+	 * @param claimed  receives the number of slots claimed
+	 * @returns the first claimed slot, or null if nothing could be claimed
+	 */
+	T *ClaimWrite(size_t wanted, size_t &claimed) noexcept
+	{
+		size_t tail = m_Tail.load(std::memory_order_relaxed);
+		size_t offset = tail & m_Mask;
+
+		claimed = (std::min)((std::min)(wanted, FreeSlots(tail, wanted)), m_Capacity - offset);
+		return (claimed == 0 ? nullptr : &m_Slots[offset]);
+	}
+
+	/**
+	 * Publishes slots filled in place to the consumer. Producer only
+	 * @param count  the number of slots to publish, no more than were claimed
+	 */
+	void CommitWrite(size_t count) noexcept
+	{
+		m_Tail.store(m_Tail.load(std::memory_order_relaxed) + count, std::memory_order_release);
+	}
+
+	/**
+	 * Claims contiguous items so they can be processed in place. Consumer only.
+	 * Fewer items than wanted may be claimed if the ring is nearly empty or the items wrap around
+	 * @param wanted  the number of items wanted
+	 * @param claimed  receives the number of items claimed
+	 * @returns the first claimed item, or null if nothing could be claimed
+	 */
+	T *ClaimRead(size_t wanted, size_t &claimed) noexcept
+	{
+		size_t head = m_Head.load(std::memory_order_relaxed);
+		size_t offset = head & m_Mask;
+
+		claimed = (std::min)((std::min)(wanted, AvailableItems(head, wanted)), m_Capacity - offset);
+		return (claimed == 0 ? nullptr : &m_Slots[offset]);
+	}
+
+	/**
+	 * Returns processed slots to the producer. Consumer only
+	 * @param count  the number of items to release, no more than were claimed
+	 */
+	void CommitRead(size_t count) noexcept
+	{
+		m_Head.store(m_Head.load(std::memory_order_relaxed) + count, std::memory_order_release);
+	}
+};
+
+} // end of namespace
\ No newline at end of file
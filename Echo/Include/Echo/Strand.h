@@ -0,0 +1,216 @@
+#pragma once
+
+#include <Echo\WinInclude.h>
+#include <Echo\Exceptions.h>
+#include <Echo\IFunctionDispatcher.h>
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <utility>
+
+namespace Echo
+{
+
+/**
+ * Serializes the execution of functions on top of another dispatcher.
+ * Functions submitted to a strand are executed in FIFO order and never concurrently,
+ * but may run on any thread the underlying dispatcher chooses.
+ *
+ * Unlike ActionDispatchQueue the strand has no lock or kernel objects,
+ * just an intrusive lock-free queue, so it is cheap enough to have one per session.
+ */
+class Strand : public IFunctionDispatcher
+{
+private:
+	struct NodeBase
+	{
+		std::atomic<NodeBase*> m_Next;
+
+		NodeBase() noexcept : m_Next(nullptr)
+		{
+		}
+	};
+
+	struct Node : NodeBase
+	{
+		// Empty once the submitter has withdrawn it, in which case it isn't counted in m_Pending
+		std::function<void()> m_Function;
+
+		explicit Node(const std::function<void()> &function) : m_Function(function)
+		{
+		}
+	};
+
+	IFunctionDispatcher &m_Dispatcher;
+
+	// Only ever touched by the thread that is draining the strand
+	NodeBase *m_Head;
+
+	std::atomic<NodeBase*> m_Tail;
+	std::atomic<LONG> m_Pending;
+
+	// Bumped whenever a drain starts, so Submit can tell a dispatcher that refused the strand from a function that threw
+	std::atomic<ULONG> m_DrainsStarted;
+
+	NodeBase m_Stub;
+
+	/**
+	 * Adds a node to the end of the queue
+	 */
+	void Push(Node *node) noexcept
+	{
+		NodeBase *previous = m_Tail.exchange(node, std::memory_order_acq_rel);
+		previous->m_Next.store(node, std::memory_order_release);
+	}
+
+	/**
+	 * Removes the function at the head of the queue.
+	 * The caller must know that there is a pending item
+	 */
+	std::function<void()> Pop() noexcept
+	{
+		NodeBase *head = m_Head;
+		NodeBase *next = head->m_Next.load(std::memory_order_acquire);
+
+		// A producer may have swapped the tail but not yet linked the node in
+		while(next == nullptr)
+		{
+			YieldProcessor();
+			next = head->m_Next.load(std::memory_order_acquire);
+		}
+
+		// The next node becomes the new stub, so we take its function and discard the old head
+		m_Head = next;
+		auto function = std::move(static_cast<Node*>(next)->m_Function);
+
+		if(head != &m_Stub) delete static_cast<Node*>(head);
+
+		return function;
+	}
+
+	/**
+	 * Schedules the strand onto the underlying dispatcher
+	 */
+	void Schedule()
+	{
+		m_Dispatcher.Submit([this]{Drain();});
+	}
+
+	/**
+	 * Executes pending functions until the strand is empty
+	 */
+	void Drain()
+	{
+		m_DrainsStarted.fetch_add(1, std::memory_order_acq_rel);
+
+		for(;;)
+		{
+			auto function = Pop();
+			if(!function) continue;
+
+			try
+			{
+				function();
+			}
+			catch(...)
+			{
+				// Make sure anything behind us still gets to run
+				if(m_Pending.fetch_sub(1, std::memory_order_acq_rel) != 1) Schedule();
+				throw;
+			}
+
+			if(m_Pending.fetch_sub(1, std::memory_order_acq_rel) == 1) return;
+		}
+	}
+
+public:
+	/**
+	 * Initializes the instance
+	 * @param dispatcher  the dispatcher that will execute the functions
+	 */
+	explicit Strand(IFunctionDispatcher &dispatcher) noexcept : m_Dispatcher(dispatcher), m_Head(&m_Stub), m_Tail(&m_Stub), m_Pending(0), m_DrainsStarted(0)
+	{
+	}
+
+	Strand(const Strand&) = delete;
+	Strand(Strand&&) = delete;
+
+	Strand &operator=(const Strand&) = delete;
+	Strand &operator=(Strand&&) = delete;
+
+	/**
+	 * Destroys the instance.
+	 * Any functions that are still pending are allowed to run before the strand is destroyed
+	 */
+	~Strand() override
+	{
+		while(m_Pending.load(std::memory_order_acquire) != 0)
+		{
+			::SwitchToThread();
+		}
+
+		// Withdrawn nodes may still be queued behind the head
+		NodeBase *node = m_Head;
+		while(node != nullptr)
+		{
+			NodeBase *next = node->m_Next.load(std::memory_order_acquire);
+			if(node != &m_Stub) delete static_cast<Node*>(node);
+
+			node = next;
+		}
+	}
+
+	/**
+	 * Returns the number of functions waiting to run, including any that are running
+	 */
+	LONG Pending() const noexcept
+	{
+		return m_Pending.load(std::memory_order_acquire);
+	}
+
+	/**
+	 * Queues a function to run on the strand.
+	 * If the underlying dispatcher throws the function is withdrawn and the exception is rethrown
+	 */
+	virtual void Submit(const std::function<void()> &function) override
+	{
+		if(!function) throw ArgumentNullException(_T("function"));
+
+		std::unique_ptr<Node> node(new Node(function));
+
+		// Counted before it is queued, so that the submitter that moves the strand from idle to busy
+		// knows no drain is running and its node can't be consumed until the strand is scheduled
+		if(m_Pending.fetch_add(1, std::memory_order_acq_rel) != 0)
+		{
+			Push(node.release());
+			return;
+		}
+
+		Node *ours = node.release();
+		Push(ours);
+
+		const ULONG drainsStarted = m_DrainsStarted.load(std::memory_order_acquire);
+
+		try
+		{
+			Schedule();
+		}
+		catch(...)
+		{
+			// A dispatcher that runs the drain inline passes on exceptions from the functions, which Drain has already dealt with
+			if(m_DrainsStarted.load(std::memory_order_acquire) != drainsStarted) throw;
+
+			// Nothing else drains the strand until it is scheduled, so our node is still queued.
+			// Emptying it withdraws it, and Drain skips it without counting it
+			ours->m_Function = nullptr;
+
+			// Anything queued behind us in the meantime was left for us to schedule
+			if(m_Pending.fetch_sub(1, std::memory_order_acq_rel) != 1) Schedule();
+
+			throw;
+		}
+	}
+};
+
+} // end of namespace
\ No newline at end of file
@@ -3,6 +3,7 @@
 #include <Echo\WaitHandle.h>
 #include <Echo\HandleTraits.h>
 #include <Echo\Exceptions.h>
+#include <Echo\ThreadOptions.h>
 
 #include <functional>
 #include <process.h>
@@ -19,6 +20,7 @@ private:
 	typedef WaitHandleImpl<HandleNull> Base;
 
 	std::function<void()> m_ThreadFunction;
+	ThreadOptions m_Options;
 
 	static unsigned __stdcall ThreadMain(void *data)
 	{
@@ -39,11 +41,20 @@ public:
 
 	}
 
+	/**
+	 * Initializes the instance
+	 * @param threadFunction  the function to execute on the thread
+	 * @param options  how the thread should be created and configured
+	 */
+	Thread(const std::function<void()> &threadFunction, const ThreadOptions &options) : m_ThreadFunction(threadFunction), m_Options(options)
+	{
+	}
+
 	/**
 	 * Initializes the instance
 	 * @param rhs  the thread to move into this instance
 	 */
-	Thread(Thread &&rhs) : Base(std::move(rhs)), m_ThreadFunction(std::move(rhs.m_ThreadFunction))
+	Thread(Thread &&rhs) : Base(std::move(rhs)), m_ThreadFunction(std::move(rhs.m_ThreadFunction)), m_Options(std::move(rhs.m_Options))
 	{
 	}
 
@@ -60,6 +71,7 @@ public:
 		if(this != &rhs)
 		{
 			std::swap(m_ThreadFunction, rhs.m_ThreadFunction);
+			std::swap(m_Options, rhs.m_Options);
 			Swap(rhs);
 			rhs.Close();
 		}
@@ -74,8 +86,35 @@ public:
 	{
 		if(UnderlyingHandle() != Traits::InvalidValue()) throw ThreadException(_T("thread already started"));
 
-		auto handle = ::_beginthreadex(nullptr, 0, ThreadMain, this, 0, nullptr);
+		// The thread starts suspended so that it is fully configured before it runs any user code
+		unsigned flags = CREATE_SUSPENDED;
+		if(m_Options.StackSize() != 0) flags |= STACK_SIZE_PARAM_IS_A_RESERVATION;
+
+		auto handle = ::_beginthreadex(nullptr, m_Options.StackSize(), ThreadMain, this, flags, nullptr);
+		if(handle == 0) throw ThreadException(_T("could not start thread"));
+
 		UnderlyingHandle(reinterpret_cast<HANDLE>(handle));
+
+		try
+		{
+			m_Options.ApplyTo(UnderlyingHandle());
+		}
+		catch(...)
+		{
+			// Let the thread run rather than leaving it suspended forever
+			::ResumeThread(UnderlyingHandle());
+			throw;
+		}
+
+		::ResumeThread(UnderlyingHandle());
+	}
+
+	/**
+	 * Returns the options the thread was created with
+	 */
+	const ThreadOptions &Options() const noexcept
+	{
+		return m_Options;
 	}
 
 	/**
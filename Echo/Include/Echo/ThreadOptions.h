@@ -0,0 +1,140 @@
+#pragma once
+
+#include <Echo\WinInclude.h>
+#include <Echo\tstring.h>
+#include <Echo\Exceptions.h>
+
+namespace Echo
+{
+
+/**
+ * Describes how a thread should be created and configured.
+ * Used by Thread and by the worker threads of a ThreadPool
+ */
+class ThreadOptions
+{
+private:
+	typedef HRESULT (WINAPI *SetThreadDescriptionFunction)(HANDLE, PCWSTR);
+
+	DWORD_PTR m_AffinityMask = 0;
+	int m_Priority = THREAD_PRIORITY_NORMAL;
+	unsigned m_StackSize = 0;
+	tstd::tstring m_Name;
+
+	/**
+	 * SetThreadDescription only exists on Windows 10 1607 onwards, so we look it up at runtime
+	 */
+	static SetThreadDescriptionFunction LookupSetThreadDescription() noexcept
+	{
+		HMODULE kernel = ::GetModuleHandle(_T("kernel32.dll"));
+		if(kernel == nullptr) return nullptr;
+
+		return reinterpret_cast<SetThreadDescriptionFunction>(::GetProcAddress(kernel, "SetThreadDescription"));
+	}
+
+public:
+	/**
+	 * Initializes the instance with the operating system defaults
+	 */
+	ThreadOptions()
+	{
+	}
+
+	/**
+	 * Returns the processors the thread may run on. Zero means any processor
+	 */
+	DWORD_PTR AffinityMask() const noexcept
+	{
+		return m_AffinityMask;
+	}
+
+	/**
+	 * Sets the processors the thread may run on, one bit per processor. Zero means any processor
+	 */
+	void AffinityMask(DWORD_PTR value) noexcept
+	{
+		m_AffinityMask = value;
+	}
+
+	/**
+	 * Returns the priority for the thread (eg THREAD_PRIORITY_NORMAL)
+	 */
+	int Priority() const noexcept
+	{
+		return m_Priority;
+	}
+
+	/**
+	 * Sets the priority for the thread (eg THREAD_PRIORITY_HIGHEST)
+	 */
+	void Priority(int value) noexcept
+	{
+		m_Priority = value;
+	}
+
+	/**
+	 * Returns the stack size to reserve for the thread, in bytes. Zero means the executable default
+	 */
+	unsigned StackSize() const noexcept
+	{
+		return m_StackSize;
+	}
+
+	/**
+	 * Sets the stack size to reserve for the thread, in bytes. Zero means the executable default
+	 */
+	void StackSize(unsigned value) noexcept
+	{
+		m_StackSize = value;
+	}
+
+	/**
+	 * Returns the name that debuggers and profilers will show for the thread
+	 */
+	const tstd::tstring &Name() const noexcept
+	{
+		return m_Name;
+	}
+
+	/**
+	 * Sets the name that debuggers and profilers will show for the thread
+	 */
+	void Name(const tstd::tstring &value)
+	{
+		m_Name = value;
+	}
+
+	/**
+	 * Applies the affinity, priority and name to a running thread.
+	 * The stack size can only be applied when the thread is created
+	 * @param thread  the thread to configure
+	 */
+	void ApplyTo(HANDLE thread) const
+	{
+		if(m_AffinityMask != 0)
+		{
+			auto previous = ::SetThreadAffinityMask(thread, m_AffinityMask);
+			if(previous == 0) throw WindowsException(_T("SetThreadAffinityMask failed"));
+		}
+
+		if(m_Priority != THREAD_PRIORITY_NORMAL)
+		{
+			auto success = ::SetThreadPriority(thread, m_Priority);
+			if(!success) throw WindowsException(_T("SetThreadPriority failed"));
+		}
+
+		if(m_Name.length() != 0)
+		{
+			static const SetThreadDescriptionFunction setThreadDescription = LookupSetThreadDescription();
+
+			// Naming is purely diagnostic, so older systems just go without
+			if(setThreadDescription)
+			{
+				auto name = tstd::to_wstring(m_Name);
+				setThreadDescription(thread, name.c_str());
+			}
+		}
+	}
+};
+
+} // end of namespace
\ No newline at end of file
@@ -4,6 +4,7 @@
 
 #include <Echo\IFunctionDispatcher.h>
 #include <Echo\Exceptions.h>
+#include <Echo\ThreadOptions.h>
 
 #include <functional>
 #include <utility>
@@ -26,6 +27,8 @@ private:
 
 	mutable LONG m_OutstandingWork;
 
+	ThreadOptions m_Options;
+
 	class ThreadData
 	{
 	private:
@@ -56,6 +59,8 @@ private:
 		{
 			std::unique_ptr<ThreadData> threadData(reinterpret_cast<ThreadData*>(context));
 			counter = &threadData->Pool()->m_OutstandingWork;
+			threadData->Pool()->ConfigureCurrentThread();
+
 			auto function = threadData->Function();
 			function();
 		}
@@ -80,6 +85,27 @@ private:
 		if(m_Pool == nullptr) throw ThreadException(_T("thread pool not started"));
 	}
 
+	/**
+	 * Applies the thread options to the worker thread we're running on.
+	 * The pool owns its threads, so each worker only needs configuring the first time it runs our work
+	 */
+	void ConfigureCurrentThread() const noexcept
+	{
+		static thread_local const ThreadPool *configuredFor = nullptr;
+		if(configuredFor == this) return;
+
+		configuredFor = this;
+
+		try
+		{
+			m_Options.ApplyTo(::GetCurrentThread());
+		}
+		catch(...)
+		{
+			// A worker that can't be configured is still able to run the work
+		}
+	}
+
 public:
 	/**
 	 * Initializes the instance
@@ -90,6 +116,26 @@ public:
 		if(m_Pool == nullptr) throw WindowsException(_T("Failed to create threadpool"));
 	}
 
+	/**
+	 * Initializes the instance
+	 * @param options  how the worker threads of the pool should be configured
+	 */
+	explicit ThreadPool(const ThreadOptions &options) : ThreadPool()
+	{
+		m_Options = options;
+
+		if(m_Options.StackSize() != 0)
+		{
+			TP_POOL_STACK_INFORMATION stackInformation;
+			stackInformation.StackReserve = m_Options.StackSize();
+			stackInformation.StackCommit = 0;
+
+			// NOTE: The delegating constructor has completed, so the destructor will close the pool if we throw
+			auto success = ::SetThreadpoolStackInformation(m_Pool, &stackInformation);
+			if(!success) throw WindowsException(_T("Failed to set threadpool stack size"));
+		}
+	}
+
 	ThreadPool(const ThreadPool&) = delete;
 	ThreadPool(ThreadPool&&) = delete;
 
@@ -168,6 +214,14 @@ public:
 		::SetThreadpoolThreadMaximum(m_Pool, value);
 	}
 
+	/**
+	 * Returns the options applied to the worker threads
+	 */
+	const ThreadOptions &Options() const noexcept
+	{
+		return m_Options;
+	}
+
 	/**
 	 * Submits an item of work to the thread pool
 	 */
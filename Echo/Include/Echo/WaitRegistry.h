@@ -0,0 +1,262 @@
+#pragma once
+
+#include <Echo\WinInclude.h>
+#include <Echo\WaitHandle.h>
+#include <Echo\Exceptions.h>
+#include <Echo\CriticalSection.h>
+#include <Echo\OnDestruct.h>
+#include <Echo\IFunctionDispatcher.h>
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace Echo
+{
+
+/**
+ * Watches any number of wait handles and calls back when they are signalled.
+ *
+ * MultiWaiter is limited to 64 handles and rescans them all on every wait. Here each handle
+ * is registered once as a thread pool wait, which the system batches onto its own wait threads,
+ * so registering or removing a handle doesn't disturb the others.
+ *
+ * Registrations are re-armed once their callback has run, even if it throws, so a manual reset event
+ * must be reset by its callback or it will fire continuously. Callbacks run on the thread pool
+ * have nowhere to report an exception to, so it is discarded; on a dispatcher it propagates
+ * to the dispatcher as any other submitted function's would.
+ *
+ * Once Unregister, Clear or the destructor returns the callback is neither running nor will run again,
+ * so it is safe to destroy anything it uses
+ */
+class WaitRegistry
+{
+public:
+	/**
+	 * Identifies a registration
+	 */
+	typedef ULONG64 Cookie;
+
+private:
+	class Registration : public std::enable_shared_from_this<Registration>
+	{
+	private:
+		const HANDLE m_Handle;
+		const std::function<void()> m_Callback;
+		IFunctionDispatcher *m_Dispatcher;
+
+		mutable CriticalSection m_SyncRoot;
+		PTP_WAIT m_Wait;
+		bool m_Active;
+		std::atomic<LONG> m_InvokesInFlight;
+
+		static void CALLBACK WaitCallback(PTP_CALLBACK_INSTANCE, void *context, PTP_WAIT, TP_WAIT_RESULT)
+		{
+			auto registration = reinterpret_cast<Registration*>(context);
+
+			// Nothing may escape into the thread pool, as it would terminate the process
+			try
+			{
+				if(registration->m_Dispatcher == nullptr)
+				{
+					registration->Invoke();
+					return;
+				}
+
+				// The dispatched call keeps us alive even if we're unregistered before it runs
+				auto self = registration->shared_from_this();
+				registration->m_Dispatcher->Submit([self]{self->Invoke();});
+			}
+			catch(...)
+			{
+				// If the dispatcher couldn't take the call keep watching the handle rather than stop for good.
+				// Setting the wait again is harmless if the callback already re-armed it
+				registration->Arm();
+			}
+		}
+
+		void Invoke()
+		{
+			{
+				Guard<CriticalSection> lock(m_SyncRoot);
+				if(m_Active == false) return;
+
+				// Counted under the lock, so Disarm either stops us here or waits for us to finish
+				m_InvokesInFlight.fetch_add(1, std::memory_order_acq_rel);
+			}
+
+			OnDestruct done([this]{m_InvokesInFlight.fetch_sub(1, std::memory_order_release);});
+
+			// Keep firing even if the callback throws
+			OnDestruct rearm([this]{Arm();});
+
+			m_Callback();
+		}
+
+	public:
+		Registration(HANDLE handle, const std::function<void()> &callback, IFunctionDispatcher *dispatcher) : m_Handle(handle), m_Callback(callback), m_Dispatcher(dispatcher), m_Wait(nullptr), m_Active(true), m_InvokesInFlight(0)
+		{
+			m_Wait = ::CreateThreadpoolWait(WaitCallback, this, nullptr);
+			if(m_Wait == nullptr) throw WindowsException(_T("could not create thread pool wait"));
+		}
+
+		Registration(const Registration&) = delete;
+		Registration &operator=(const Registration&) = delete;
+
+		~Registration()
+		{
+			if(m_Wait) ::CloseThreadpoolWait(m_Wait);
+		}
+
+		/**
+		 * Starts, or restarts, waiting on the handle
+		 */
+		void Arm()
+		{
+			Guard<CriticalSection> lock(m_SyncRoot);
+			if(m_Active) ::SetThreadpoolWait(m_Wait, m_Handle, nullptr);
+		}
+
+		/**
+		 * Stops waiting and waits for any running callback to finish, whether on the thread pool or a dispatcher.
+		 * Calls still queued on a dispatcher find the registration inactive and do nothing
+		 */
+		void Disarm()
+		{
+			{
+				Guard<CriticalSection> lock(m_SyncRoot);
+				m_Active = false;
+				::SetThreadpoolWait(m_Wait, nullptr, nullptr);
+			}
+
+			::WaitForThreadpoolWaitCallbacks(m_Wait, TRUE);
+
+			while(m_InvokesInFlight.load(std::memory_order_acquire) != 0)
+			{
+				::SwitchToThread();
+			}
+		}
+	};
+
+	mutable CriticalSection m_SyncRoot;
+	std::unordered_map<Cookie, std::shared_ptr<Registration>> m_Registrations;
+	Cookie m_NextCookie;
+
+	IFunctionDispatcher *m_Dispatcher;
+
+public:
+	/**
+	 * Initializes the instance so that callbacks run on the thread pool's wait threads
+	 */
+	WaitRegistry() : m_NextCookie(1), m_Dispatcher(nullptr)
+	{
+	}
+
+	/**
+	 * Initializes the instance so that callbacks run on a dispatcher
+	 * @param dispatcher  the dispatcher to run callbacks on
+	 */
+	explicit WaitRegistry(IFunctionDispatcher &dispatcher) : m_NextCookie(1), m_Dispatcher(&dispatcher)
+	{
+	}
+
+	WaitRegistry(const WaitRegistry&) = delete;
+	WaitRegistry(WaitRegistry&&) = delete;
+
+	WaitRegistry &operator=(const WaitRegistry&) = delete;
+	WaitRegistry &operator=(WaitRegistry&&) = delete;
+
+	/**
+	 * Destroys the instance, removing every registration
+	 */
+	~WaitRegistry()
+	{
+		Clear();
+	}
+
+	/**
+	 * Returns the number of registered handles
+	 */
+	size_t Count() const
+	{
+		Guard<CriticalSection> lock(m_SyncRoot);
+		return m_Registrations.size();
+	}
+
+	/**
+	 * Starts watching a handle.
+	 * The handle must stay open until it is unregistered
+	 * @param handle  the handle to watch
+	 * @param callback  the function to call each time the handle is signalled
+	 * @returns a cookie that can be passed to Unregister
+	 */
+	Cookie Register(const WaitHandle &handle, const std::function<void()> &callback)
+	{
+		if(!callback) throw ArgumentNullException(_T("callback"));
+
+		auto registration = std::make_shared<Registration>(handle.UnderlyingHandle(), callback, m_Dispatcher);
+		Cookie cookie = 0;
+
+		{
+			Guard<CriticalSection> lock(m_SyncRoot);
+
+			cookie = m_NextCookie++;
+			m_Registrations.emplace(cookie, registration);
+		}
+
+		registration->Arm();
+		return cookie;
+	}
+
+	/**
+	 * Stops watching a handle, waiting for its callback to finish if it is running.
+	 * Must not be called from the callback of the registration being removed
+	 * @param cookie  the cookie returned by Register
+	 * @returns true if the registration was removed, false if it didn't exist
+	 */
+	bool Unregister(Cookie cookie)
+	{
+		std::shared_ptr<Registration> registration;
+
+		{
+			Guard<CriticalSection> lock(m_SyncRoot);
+
+			auto it = m_Registrations.find(cookie);
+			if(it == m_Registrations.end()) return false;
+
+			registration = std::move(it->second);
+			m_Registrations.erase(it);
+		}
+
+		registration->Disarm();
+		return true;
+	}
+
+	/**
+	 * Removes every registration
+	 */
+	void Clear()
+	{
+		std::vector<std::shared_ptr<Registration>> registrations;
+
+		{
+			Guard<CriticalSection> lock(m_SyncRoot);
+
+			for(auto &pair : m_Registrations)
+			{
+				registrations.push_back(std::move(pair.second));
+			}
+
+			m_Registrations.clear();
+		}
+
+		for(auto &registration : registrations)
+		{
+			registration->Disarm();
+		}
+	}
+};
+
+} // end of namespace
\ No newline at end of file
@@ -3,19 +3,27 @@
 #include <Echo\OnDestruct.h>
 
 #include <Echo\CriticalSection.h>
-#include <Echo\Events.h>
+#include <Echo\LightEvent.h>
+#include <Echo\MonotonicArena.h>
 #include <Echo\Exceptions.h>
 #include <Echo\ThreadPool.h>
 
 #include <deque>
+#include <utility>
 
 namespace Echo 
 {
 
 /**
- * A work queue that allows work to be farmed off onto another thread
+ * A work queue that allows work to be farmed off onto another thread.
+ * The LOCK type protects the queue and must have Guard and Unguard specializations,
+ * so a SpinLock can be used when the queue is hot and the hold times are tiny.
+ *
+ * Whilst items are being processed the queue's arena is the thread's current arena,
+ * so handlers can take scratch memory from MonotonicArena::Current(). It's reset at the
+ * end of each activation of the processing thread
  */
-template<typename T>
+template<typename T, typename LOCK = CriticalSection>
 class WorkDispatchQueue
 {
 private:
@@ -26,8 +34,10 @@ private:
 
 	IFunctionDispatcher &m_Dispatcher;
 	
-	mutable CriticalSection m_SyncRoot;
-	const AutoResetEvent m_StopEvent;
+	mutable LOCK m_SyncRoot;
+	const AutoResetLightEvent m_StopEvent;
+
+	MonotonicArena m_Arena;
 
 	bool m_ThreadActive = false;
 	bool m_StopProcessing = false;
@@ -55,20 +65,43 @@ private:
 	}
 
 	/**
-	 * Enqueues data to be worked on
+	 * Enqueues data to be worked on, copying or moving it. Must be called with the lock held
+	 * @returns true if the processing thread needs to be started by calling Activate once the lock is released
 	 */
-	void DoEnqueue(const T &data)
+	template<typename U>
+	bool DoEnqueue(U &&data)
 	{
 		if(m_Shutdown) throw ThreadException(_T("dispatch queue has been shut down"));
 
-		m_ActiveData->push_back(data);
+		m_ActiveData->push_back(std::forward<U>(data));
+
+		if(m_ThreadActive) return false;
 
-		if(m_ThreadActive == false)
+		m_ThreadActive = true;
+		return true;
+	}
+
+	/**
+	 * Starts the processing thread. This is called outside the lock, as the dispatcher
+	 * may run ProcessQueue inline and LOCK need not be re-entrant
+	 */
+	void Activate()
+	{
+		try
 		{
-			m_ThreadActive = true;
 			auto function = [this]{ProcessQueue();};
 			m_Dispatcher.Submit(function);
 		}
+		catch(...)
+		{
+			Guard<LOCK> lock(m_SyncRoot);
+			m_ThreadActive = false;
+
+			// Shutdown may already be waiting for the thread that never started
+			if(m_StopProcessing) m_StopEvent.Set();
+
+			throw;
+		}
 	}
 
 	/**
@@ -76,14 +109,15 @@ private:
 	 */
 	void ProcessQueue()
 	{
-		Guard<CriticalSection> lock(m_SyncRoot);
+		ArenaScope arenaScope(m_Arena);
+		Guard<LOCK> lock(m_SyncRoot);
 
 		while(m_ActiveData->size() != 0 && m_StopProcessing == false)
 		{
 			std::deque<T> &data = SwitchActive();
 
 			// We can exit the lock now
-			Unguard<CriticalSection> unlock(m_SyncRoot);
+			Unguard<LOCK> unlock(m_SyncRoot);
 
 			// Make sure we clear out the data regardless of what happens
 			Echo::OnDestruct onDestruct([&]{data.clear();});
@@ -91,13 +125,19 @@ private:
 			ProcessItems(data);
 		}
 
-		// We're back in the lock here
+		// We're back in the lock here, so nothing else can be using the arena
+		m_Arena.Reset();
 		m_ThreadActive = false;
 
 		if(m_StopProcessing)
 		{
 			// Process anything that's left
-			if(m_ProcessRemainingItems) ProcessItems(*m_ActiveData);
+			if(m_ProcessRemainingItems)
+			{
+				ProcessItems(*m_ActiveData);
+				m_Arena.Reset();
+			}
+
 			m_StopEvent.Set();
 		}
 	}
@@ -136,6 +176,14 @@ protected:
 		return m_ProcessRemainingItems;
 	}
 
+	/**
+	 * Returns the arena that is current whilst items are processed
+	 */
+	MonotonicArena &Arena() noexcept
+	{
+		return m_Arena;
+	}
+
 public:
 	/**
 	 * Initializes the instance
@@ -166,8 +214,30 @@ public:
 	 */
 	void Enqueue(const T &data)
 	{
-		Guard<CriticalSection> lock(m_SyncRoot);
-		DoEnqueue(data);
+		bool activate = false;
+
+		{
+			Guard<LOCK> lock(m_SyncRoot);
+			activate = DoEnqueue(data);
+		}
+
+		if(activate) Activate();
+	}
+
+	/**
+	 * Adds a work item to the queue by moving it, so move-only items such as pooled pointers can be queued.
+	 * If the queue has been shut down the method will fail
+	 */
+	void Enqueue(T &&data)
+	{
+		bool activate = false;
+
+		{
+			Guard<LOCK> lock(m_SyncRoot);
+			activate = DoEnqueue(std::move(data));
+		}
+
+		if(activate) Activate();
 	}
 
 	/**
@@ -177,11 +247,38 @@ public:
 	 */
 	bool TryEnqueue(const T &data)
 	{
-		Guard<CriticalSection> lock(m_SyncRoot);
+		bool activate = false;
+
+		{
+			Guard<LOCK> lock(m_SyncRoot);
+
+			if(m_Shutdown) return false;
+
+			activate = DoEnqueue(data);
+		}
+
+		if(activate) Activate();
+		return true;
+	}
+
+	/**
+	 * Attempts to add a work item to the queue by moving it.
+	 * If the queue has been shut down then the work item will not be queued, and is left untouched
+	 * @returns true if the item was queued for processing, false if it could not be queue
+	 */
+	bool TryEnqueue(T &&data)
+	{
+		bool activate = false;
+
+		{
+			Guard<LOCK> lock(m_SyncRoot);
+
+			if(m_Shutdown) return false;
 
-		if(m_Shutdown) return false;
+			activate = DoEnqueue(std::move(data));
+		}
 
-		DoEnqueue(data);
+		if(activate) Activate();
 		return true;
 	}
 
@@ -194,7 +291,7 @@ public:
 		bool shouldWait = false;
 
 		{
-			Guard<CriticalSection> lock(m_SyncRoot);
+			Guard<LOCK> lock(m_SyncRoot);
 
 			if(m_Shutdown) return;
 
@@ -4,11 +4,9 @@
 #include "stdafx.h"
 
 #include <Echo\ThreadPool.h>
-#include <Echo\Events.h>
+#include <Echo\Latch.h>
 #include <Echo\tstring.h>
 
-#include <atomic>
-
 int main()
 {
 	using namespace Echo;
@@ -16,9 +14,7 @@ int main()
 	const char *greeting = "Hello, world!";
 	auto converted = tstd::to_wstring(greeting);
 
-	std::atomic<int> counter(0);
-
-	ManualResetEvent event(InitialState::NonSignalled);
+	Latch latch(1000);
 
 	{
 		ThreadPool pool;
@@ -31,15 +27,14 @@ int main()
 		{
 			pool.Submit([&]
 			{
-				counter.fetch_add(1);
-				if(counter == 1000) event.Set();
+				latch.CountDown();
 			});
 		}
 
 		pool.CancelOutstanding(false);
 	}
 
-	event.Wait();
+	latch.Wait();
 
     return 0;   
 }
@@ -0,0 +1,114 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+#include <Echo\Barrier.h>
+#include <Echo\Thread.h>
+
+#include <atomic>
+#include <vector>
+
+namespace EchoUnitTest 
+{
+
+TEST_CLASS(BarrierTests)
+{
+public:
+	TEST_METHOD(Construct)
+	{
+		using namespace Echo;
+
+		Barrier barrier(3);
+		Assert::AreEqual(3L,barrier.ParticipantCount());
+		Assert::AreEqual(3L,barrier.ParticipantsRemaining());
+		Assert::AreEqual(0UL,barrier.Phase());
+	}
+
+	TEST_METHOD(SingleParticipant)
+	{
+		using namespace Echo;
+
+		int completions=0;
+		Barrier barrier(1, [&]{completions++;});
+
+		barrier.ArriveAndWait();
+		barrier.ArriveAndWait();
+
+		Assert::AreEqual(2,completions);
+		Assert::AreEqual(2UL,barrier.Phase());
+	}
+
+	TEST_METHOD(Timeout)
+	{
+		using namespace Echo;
+
+		Barrier barrier(2);
+		Assert::IsFalse(barrier.ArriveAndWait(std::chrono::milliseconds(50)));
+		Assert::AreEqual(1L,barrier.ParticipantsRemaining());
+	}
+
+	TEST_METHOD(DestroyAfterWait)
+	{
+		using namespace Echo;
+
+		// The waiter frees the barrier as soon as it is released, whilst the last arriver may still be finishing the phase
+		for(int i=0; i<1000; i++)
+		{
+			auto barrier=new Barrier(2, nullptr, (i%2) ? 0 : Barrier::DefaultSpinCount);
+
+			Thread waiter([barrier]
+			{
+				barrier->ArriveAndWait();
+				delete barrier;
+			});
+
+			waiter.Start();
+			while(barrier->ParticipantsRemaining()!=1) ::SwitchToThread();
+
+			barrier->ArriveAndWait();
+			waiter.Wait();
+		}
+	}
+
+	TEST_METHOD(Phases)
+	{
+		using namespace Echo;
+
+		const int threadCount=4;
+		const int phases=1000;
+
+		std::atomic<int> arrivals(0);
+		std::atomic<bool> outOfStep(false);
+		int completions=0;
+
+		// Runs with every participant held at the barrier, so the arrivals must line up with the phase
+		Barrier barrier(threadCount, [&]
+		{
+			completions++;
+			if(arrivals.load()!=completions*threadCount) outOfStep=true;
+		}, 0);
+
+		std::vector<Thread> threads;
+		for(int i=0; i<threadCount; i++)
+		{
+			threads.emplace_back([&]
+			{
+				for(int j=0; j<phases; j++)
+				{
+					arrivals++;
+					barrier.ArriveAndWait();
+				}
+			});
+		}
+
+		for(auto &thread : threads) thread.Start();
+		for(auto &thread : threads) thread.Wait();
+
+		Assert::IsFalse(outOfStep.load());
+		Assert::AreEqual(phases,completions);
+		Assert::AreEqual((ULONG)phases,barrier.Phase());
+	}
+};
+
+} // end of namespace
\ No newline at end of file
@@ -0,0 +1,98 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+#include <Echo\BufferPool.h>
+#include <Echo\Thread.h>
+
+#include <cstdint>
+#include <vector>
+
+namespace EchoUnitTest 
+{
+
+TEST_CLASS(BufferPoolTests)
+{
+public:
+	TEST_METHOD(Acquire)
+	{
+		using namespace Echo;
+
+		BufferPool pool(8192);
+		auto buffer=pool.Acquire();
+
+		size_t pageSize=Environment::PageSize();
+		Assert::AreEqual((size_t)8192,buffer.Size());
+		Assert::AreEqual(pageSize,buffer.Alignment());
+		Assert::AreEqual((uintptr_t)0,reinterpret_cast<uintptr_t>(buffer.Data()) & (pageSize-1));
+	}
+
+	TEST_METHOD(ReturnedOnDestruction)
+	{
+		using namespace Echo;
+
+		BufferPool pool(1024,64);
+		void *first=nullptr;
+
+		{
+			auto buffer=pool.Acquire();
+			first=buffer.Data();
+		}
+
+		// The most recently returned buffer is the next one handed out
+		auto buffer=pool.Acquire();
+		Assert::IsTrue(buffer.Data()==first);
+	}
+
+	TEST_METHOD(Preallocate)
+	{
+		using namespace Echo;
+
+		BufferPool pool(512,64,100);
+		size_t capacity=pool.Capacity();
+		Assert::IsTrue(capacity>=100);
+
+		std::vector<Buffer> buffers;
+		for(int i=0; i<100; i++) buffers.push_back(pool.Acquire());
+
+		Assert::AreEqual(capacity,pool.Capacity());
+	}
+
+	TEST_METHOD(AcrossThreads)
+	{
+		using namespace Echo;
+
+		BufferPool pool(256,64);
+		std::vector<Buffer> buffers;
+
+		for(int round=0; round<10; round++)
+		{
+			for(int i=0; i<100; i++) buffers.push_back(pool.Acquire());
+
+			// Release on another thread, which sends the buffers back to the pool's depot
+			Thread thread([&]{buffers.clear();});
+			thread.Start();
+			thread.Wait();
+		}
+
+		Assert::IsTrue(pool.Capacity()<1000);
+	}
+
+	TEST_METHOD(LargeBuffers)
+	{
+		using namespace Echo;
+
+		// Large buffers come one per slab rather than a whole magazine's worth at once
+		BufferPool pool(1024*1024);
+
+		auto buffer=pool.Acquire();
+		Assert::AreEqual((size_t)1024*1024,buffer.Size());
+		Assert::AreEqual((size_t)1,pool.Capacity());
+
+		auto another=pool.Acquire();
+		Assert::AreEqual((size_t)2,pool.Capacity());
+	}
+};
+
+} // end of namespace
\ No newline at end of file
@@ -4,6 +4,9 @@
 using namespace Microsoft::VisualStudio::CppUnitTestFramework;
 
 #include <Echo\Buffer.h>
+#include <Echo\Environment.h>
+
+#include <cstdint>
 
 namespace EchoUnitTest 
 {
@@ -50,6 +53,66 @@ public:
 		}
 	}
 
+	TEST_METHOD(Aligned)
+	{
+		using namespace Echo;
+
+		Buffer buffer(100,64);
+		Assert::AreEqual((size_t)64,buffer.Alignment());
+		Assert::AreEqual((uintptr_t)0,reinterpret_cast<uintptr_t>(buffer.Data()) & 63);
+
+		Assert::ExpectException<ArgumentException>([]{Buffer bad(16,3);});
+	}
+
+	TEST_METHOD(ForIO)
+	{
+		using namespace Echo;
+
+		auto buffer=Buffer::ForIO(4096);
+		size_t pageSize=Environment::PageSize();
+
+		Assert::AreEqual(pageSize,buffer.Alignment());
+		Assert::AreEqual((uintptr_t)0,reinterpret_cast<uintptr_t>(buffer.Data()) & (pageSize-1));
+	}
+
+	TEST_METHOD(Move)
+	{
+		using namespace Echo;
+
+		Buffer buffer(16,32);
+		void *data=buffer.Data();
+
+		Buffer other(std::move(buffer));
+		Assert::IsTrue(other.Data()==data);
+		Assert::AreEqual((size_t)32,other.Alignment());
+		Assert::IsNull(buffer.Data());
+	}
+
+	TEST_METHOD(LargePages)
+	{
+		using namespace Echo;
+
+		// Falls back to standard pages if the process can't use large pages
+		auto buffer=Buffer::WithLargePages(1024*1024);
+		Assert::AreEqual((size_t)1024*1024,buffer.Size());
+
+		if(buffer.Pages()==PageMode::Large)
+		{
+			Assert::AreEqual((size_t)LargePages::MinimumSize(),buffer.Alignment());
+		}
+		else
+		{
+			Assert::AreEqual((size_t)Environment::PageSize(),buffer.Alignment());
+		}
+
+		buffer.Fill(7);
+		Assert::AreEqual((BYTE)7,buffer.DataAs<BYTE>()[buffer.Size()-1]);
+
+		auto pages=buffer.Pages();
+		Buffer moved(std::move(buffer));
+		Assert::IsTrue(moved.Pages()==pages);
+	}
+
 };
 
 } // end of namespace
\ No newline at end of file
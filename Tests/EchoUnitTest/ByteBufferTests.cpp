@@ -0,0 +1,149 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+#include <Echo\ByteBuffer.h>
+
+#include <cstdint>
+#include <cstring>
+
+namespace EchoUnitTest 
+{
+
+TEST_CLASS(ByteBufferTests)
+{
+public:
+	TEST_METHOD(Construct)
+	{
+		using namespace Echo;
+
+		ByteBuffer buffer(64);
+		Assert::AreEqual((size_t)0,buffer.Size());
+		Assert::AreEqual((size_t)64,buffer.Capacity());
+		Assert::IsTrue(buffer.IsEmpty());
+	}
+
+	TEST_METHOD(Growth)
+	{
+		using namespace Echo;
+
+		ByteBuffer buffer(4);
+
+		for(int i=0; i<100; i++) buffer.AppendValue(i);
+
+		Assert::AreEqual(100*sizeof(int),buffer.Size());
+		Assert::IsTrue(buffer.Capacity()>=buffer.Size());
+		Assert::AreEqual(99,buffer.DataAs<int>()[99]);
+	}
+
+	TEST_METHOD(Reserve)
+	{
+		using namespace Echo;
+
+		ByteBuffer buffer;
+		buffer.Reserve(1000);
+		Assert::AreEqual((size_t)1000,buffer.Capacity());
+
+		void *data=buffer.Data();
+		buffer.ResizeUninitialized(1000);
+		Assert::IsTrue(buffer.Data()==data);
+	}
+
+	TEST_METHOD(AppendInPlace)
+	{
+		using namespace Echo;
+
+		ByteBuffer buffer;
+		buffer.AppendValue<std::uint8_t>(1);
+
+		auto bytes=static_cast<std::uint8_t*>(buffer.AppendUninitialized(3));
+		bytes[0]=2;
+		bytes[1]=3;
+		bytes[2]=4;
+
+		Assert::AreEqual((size_t)4,buffer.Size());
+		Assert::AreEqual((std::uint8_t)4,buffer.DataAs<std::uint8_t>()[3]);
+	}
+
+	TEST_METHOD(ReadCursor)
+	{
+		using namespace Echo;
+
+		ByteBuffer buffer;
+		buffer.AppendValue<int>(42);
+		buffer.AppendValue<double>(1.5);
+
+		Assert::AreEqual(42,buffer.ReadValue<int>());
+		Assert::AreEqual(1.5,buffer.ReadValue<double>());
+		Assert::AreEqual((size_t)0,buffer.Remaining());
+
+		Assert::ExpectException<Exception>([&]{buffer.ReadValue<int>();});
+
+		buffer.ReadPosition(0);
+		Assert::AreEqual(42,buffer.ReadValue<int>());
+	}
+
+	TEST_METHOD(Detach)
+	{
+		using namespace Echo;
+
+		ByteBuffer buffer(256,64);
+		buffer.Append("hello",5);
+		const void *data=buffer.Data();
+
+		Buffer detached=buffer.Detach();
+		Assert::IsTrue(detached.Data()==data);
+		Assert::AreEqual((size_t)5,detached.Size());
+		Assert::AreEqual((size_t)64,detached.Alignment());
+		Assert::AreEqual(0,::memcmp(detached.Data(),"hello",5));
+
+		// The buffer can be reused after detaching
+		Assert::AreEqual((size_t)0,buffer.Size());
+		buffer.Append("again",5);
+		Assert::AreEqual((size_t)5,buffer.Size());
+	}
+
+	TEST_METHOD(AsReaderWriter)
+	{
+		using namespace Echo;
+
+		ByteBuffer buffer;
+		IReaderWriter &stream=buffer;
+
+		Assert::AreEqual((DWORD)4,stream.Write("abcd",4));
+
+		OVERLAPPED overlapped={};
+		Assert::IsTrue(stream.WriteAsync("ef",2,overlapped)==AsyncResult::Complete);
+		Assert::AreEqual((DWORD)2,stream.WaitForAsyncToComplete(overlapped));
+
+		char text[8]={};
+		Assert::AreEqual((DWORD)6,stream.Read(text,sizeof(text)));
+		Assert::AreEqual(0,::memcmp(text,"abcdef",6));
+		Assert::AreEqual((DWORD)0,stream.Read(text,sizeof(text)));
+	}
+
+	TEST_METHOD(Vectored)
+	{
+		using namespace Echo;
+
+		ByteBuffer buffer;
+		IReaderWriter &stream=buffer;
+
+		ConstIoSegment writes[]={{"head",4},{"",0},{"payload",7}};
+		Assert::AreEqual((DWORD)11,stream.WriteV(writes,3));
+		Assert::AreEqual(0,::memcmp(buffer.Data(),"headpayload",11));
+
+		char head[4]={};
+		char payload[16]={};
+		IoSegment reads[]={{head,4},{payload,sizeof(payload)}};
+
+		OVERLAPPED overlapped={};
+		Assert::IsTrue(stream.ReadVAsync(reads,2,overlapped)==AsyncResult::Complete);
+		Assert::AreEqual((DWORD)11,stream.WaitForAsyncToComplete(overlapped));
+		Assert::AreEqual(0,::memcmp(head,"head",4));
+		Assert::AreEqual(0,::memcmp(payload,"payload",7));
+	}
+};
+
+} // end of namespace
\ No newline at end of file
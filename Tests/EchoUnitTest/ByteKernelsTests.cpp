@@ -0,0 +1,239 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+#include <Echo\ByteKernels.h>
+#include <Echo\Buffer.h>
+#include <Echo\SharedBuffer.h>
+#include <Echo\ByteBuffer.h>
+
+#include <cstring>
+#include <vector>
+
+namespace EchoUnitTest 
+{
+
+TEST_CLASS(ByteKernelsTests)
+{
+public:
+	static std::vector<BYTE> MakePattern(size_t size)
+	{
+		std::vector<BYTE> data(size);
+		for(size_t i=0; i<size; i++) data[i]=static_cast<BYTE>((i*7)%251);
+
+		return data;
+	}
+
+	static size_t NaiveFind(const BYTE *data, size_t size, BYTE value)
+	{
+		for(size_t i=0; i<size; i++)
+		{
+			if(data[i]==value) return i;
+		}
+
+		return Echo::ByteKernels::NotFound;
+	}
+
+	static size_t NaiveCount(const BYTE *data, size_t size, BYTE value)
+	{
+		size_t count=0;
+		for(size_t i=0; i<size; i++)
+		{
+			if(data[i]==value) count++;
+		}
+
+		return count;
+	}
+
+	TEST_METHOD(Level)
+	{
+		using namespace Echo;
+
+		// The vector kernels need SSE2, so the level has to agree with what Windows reports
+		auto level=ByteKernels::Level();
+		bool sse2=(::IsProcessorFeaturePresent(PF_XMMI64_INSTRUCTIONS_AVAILABLE)!=FALSE);
+		Assert::AreEqual(sse2,level!=SimdLevel::Scalar);
+
+#if defined(_M_X64)
+		// SSE2 is part of the x64 baseline
+		Assert::IsTrue(level>=SimdLevel::Sse2);
+#endif
+	}
+
+	TEST_METHOD(Mismatch)
+	{
+		using namespace Echo;
+
+		// Every size and difference position, so each vector width and its tail is exercised
+		for(size_t size=0; size<300; size++)
+		{
+			auto lhs=MakePattern(size+1);
+			auto rhs=lhs;
+
+			Assert::AreEqual(size,ByteKernels::Mismatch(lhs.data()+1,rhs.data()+1,size));
+			Assert::IsTrue(ByteKernels::Equal(lhs.data()+1,rhs.data()+1,size));
+
+			for(size_t position=0; position<size; position+=(size/17)+1)
+			{
+				auto changed=rhs;
+				changed[position+1]^=0x80;
+
+				Assert::AreEqual(position,ByteKernels::Mismatch(lhs.data()+1,changed.data()+1,size));
+				Assert::IsFalse(ByteKernels::Equal(lhs.data()+1,changed.data()+1,size));
+			}
+		}
+	}
+
+	TEST_METHOD(Find)
+	{
+		using namespace Echo;
+
+		for(size_t size=0; size<300; size++)
+		{
+			auto data=MakePattern(size);
+
+			for(int value=0; value<256; value+=13)
+			{
+				auto expected=NaiveFind(data.data(),size,static_cast<BYTE>(value));
+				Assert::AreEqual(expected,ByteKernels::Find(data.data(),size,static_cast<BYTE>(value)));
+			}
+		}
+	}
+
+	TEST_METHOD(Find_Last)
+	{
+		using namespace Echo;
+
+		std::vector<BYTE> data(1000,0);
+		data[999]=1;
+
+		Assert::AreEqual((size_t)999,ByteKernels::Find(data.data(),data.size(),1));
+		Assert::AreEqual(ByteKernels::NotFound,ByteKernels::Find(data.data(),999,1));
+	}
+
+	TEST_METHOD(Count)
+	{
+		using namespace Echo;
+
+		for(size_t size=0; size<300; size++)
+		{
+			auto data=MakePattern(size);
+
+			for(int value=0; value<256; value+=13)
+			{
+				auto expected=NaiveCount(data.data(),size,static_cast<BYTE>(value));
+				Assert::AreEqual(expected,ByteKernels::Count(data.data(),size,static_cast<BYTE>(value)));
+			}
+		}
+	}
+
+	TEST_METHOD(Count_Large)
+	{
+		using namespace Echo;
+
+		// Large enough for the per lane counters to have to be flushed many times
+		std::vector<BYTE> data(1024*1024+37,0x55);
+		data[12345]=0;
+
+		Assert::AreEqual(data.size()-1,ByteKernels::Count(data.data(),data.size(),0x55));
+		Assert::AreEqual((size_t)1,ByteKernels::Count(data.data(),data.size(),0));
+	}
+
+	TEST_METHOD(FindPattern)
+	{
+		using namespace Echo;
+
+		auto data=MakePattern(500);
+
+		for(size_t patternSize=1; patternSize<40; patternSize+=3)
+		{
+			for(size_t offset=0; offset+patternSize<=data.size(); offset+=29)
+			{
+				auto found=ByteKernels::FindPattern(data.data(),data.size(),data.data()+offset,patternSize);
+				Assert::IsTrue(found<=offset);
+				Assert::IsTrue(std::memcmp(data.data()+found,data.data()+offset,patternSize)==0);
+			}
+		}
+	}
+
+	TEST_METHOD(FindPattern_PartialMatches)
+	{
+		using namespace Echo;
+
+		// The first and last bytes match everywhere, so only the middle tells them apart
+		std::vector<BYTE> data(200,'a');
+		const char pattern[]="abba";
+
+		Assert::AreEqual(ByteKernels::NotFound,ByteKernels::FindPattern(data.data(),data.size(),pattern,4));
+
+		std::memcpy(data.data()+150,pattern,4);
+		Assert::AreEqual((size_t)150,ByteKernels::FindPattern(data.data(),data.size(),pattern,4));
+	}
+
+	TEST_METHOD(FindPattern_Edges)
+	{
+		using namespace Echo;
+
+		const char data[]="hello world";
+
+		Assert::AreEqual((size_t)0,ByteKernels::FindPattern(data,11,"",0));
+		Assert::AreEqual(ByteKernels::NotFound,ByteKernels::FindPattern(data,5,"hello world",11));
+		Assert::AreEqual((size_t)6,ByteKernels::FindPattern(data,11,"world",5));
+		Assert::AreEqual((size_t)0,ByteKernels::FindPattern(data,11,"hello world",11));
+	}
+
+	TEST_METHOD(Crc32c)
+	{
+		using namespace Echo;
+
+		const char check[]="123456789";
+		Assert::AreEqual(0xE3069283u,ByteKernels::Crc32c(check,9));
+		Assert::AreEqual(0u,ByteKernels::Crc32c(check,0));
+	}
+
+	TEST_METHOD(Crc32c_Chained)
+	{
+		using namespace Echo;
+
+		auto data=MakePattern(1000);
+		auto whole=ByteKernels::Crc32c(data.data(),data.size());
+
+		for(size_t split=0; split<=data.size(); split+=97)
+		{
+			auto crc=ByteKernels::Crc32c(data.data(),split);
+			crc=ByteKernels::Crc32c(data.data()+split,data.size()-split,crc);
+
+			Assert::AreEqual(whole,crc);
+		}
+	}
+
+	TEST_METHOD(Buffers)
+	{
+		using namespace Echo;
+
+		Buffer buffer(100);
+		buffer.Fill('x');
+		buffer.DataAs<BYTE>()[60]='y';
+
+		Assert::AreEqual((size_t)60,ByteKernels::Find(buffer,'y'));
+		Assert::AreEqual((size_t)99,ByteKernels::Count(buffer,'x'));
+		Assert::AreEqual((size_t)59,ByteKernels::FindPattern(buffer,"xy",2));
+
+		SharedBuffer shared(std::move(buffer));
+		auto slice=shared.Slice(50,20);
+
+		Assert::AreEqual((size_t)10,ByteKernels::Find(slice,'y'));
+		Assert::AreEqual((size_t)19,ByteKernels::Count(slice,'x'));
+		Assert::AreEqual(ByteKernels::Crc32c(slice.Data(),slice.Size()),ByteKernels::Crc32c(slice));
+
+		ByteBuffer bytes;
+		bytes.Append(slice.Data(),slice.Size());
+
+		Assert::IsTrue(ByteKernels::Equal(slice,shared.Slice(50,20)));
+		Assert::IsFalse(ByteKernels::Equal(slice,shared.Slice(51,20)));
+		Assert::AreEqual((size_t)10,ByteKernels::Find(bytes,'y'));
+	}
+};
+
+} // end of namespace
\ No newline at end of file
@@ -0,0 +1,104 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+#include <Echo\CountdownEvent.h>
+#include <Echo\ThreadPool.h>
+
+#include <atomic>
+#include <functional>
+
+namespace EchoUnitTest 
+{
+
+TEST_CLASS(CountdownEventTests)
+{
+public:
+	TEST_METHOD(Construct)
+	{
+		using namespace Echo;
+
+		CountdownEvent event(2);
+		Assert::AreEqual(2L,event.CurrentCount());
+		Assert::IsFalse(event.IsSet());
+	}
+
+	TEST_METHOD(Signal)
+	{
+		using namespace Echo;
+
+		CountdownEvent event(2);
+		Assert::IsFalse(event.Signal());
+		Assert::IsFalse(event.Wait(std::chrono::milliseconds(50)));
+
+		Assert::IsTrue(event.Signal());
+		Assert::IsTrue(event.Wait(std::chrono::milliseconds(0)));
+	}
+
+	TEST_METHOD(AddCount)
+	{
+		using namespace Echo;
+
+		CountdownEvent event(1);
+		event.AddCount(2);
+		Assert::AreEqual(3L,event.CurrentCount());
+
+		Assert::IsTrue(event.Signal(3));
+		Assert::IsFalse(event.TryAddCount());
+		Assert::ExpectException<ThreadException>([&]{event.AddCount();});
+	}
+
+	TEST_METHOD(Reset)
+	{
+		using namespace Echo;
+
+		CountdownEvent event(1);
+		event.Signal();
+		Assert::IsTrue(event.IsSet());
+
+		event.Reset(2);
+		Assert::IsFalse(event.IsSet());
+		Assert::AreEqual(2L,event.CurrentCount());
+	}
+
+	TEST_METHOD(DynamicForkJoin)
+	{
+		using namespace Echo;
+
+		ThreadPool pool;
+		pool.Start();
+
+		std::atomic<int> ran(0);
+
+		// The initial count belongs to the submitter, so the event can't be set whilst work is still being added
+		CountdownEvent event(1);
+
+		std::function<void(int)> spawn=[&](int depth)
+		{
+			ran++;
+
+			if(depth<4)
+			{
+				for(int i=0; i<3; i++)
+				{
+					event.AddCount();
+					pool.Submit([&spawn,depth]{spawn(depth+1);});
+				}
+			}
+
+			event.Signal();
+		};
+
+		event.AddCount();
+		pool.Submit([&]{spawn(0);});
+		event.Signal();
+
+		Assert::IsTrue(event.Wait(std::chrono::seconds(10)));
+
+		// 1 + 3 + 9 + 27 + 81
+		Assert::AreEqual(121,ran.load());
+	}
+};
+
+} // end of namespace
\ No newline at end of file
@@ -0,0 +1,179 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+#include <Echo\Epoch.h>
+#include <Echo\ImmediateWorkItemDispatcher.h>
+#include <Echo\Thread.h>
+
+#include <atomic>
+#include <vector>
+
+namespace EchoUnitTest 
+{
+
+TEST_CLASS(EpochTests)
+{
+private:
+	struct Node
+	{
+		static std::atomic<int> s_Live;
+
+		int Value;
+
+		explicit Node(int value) : Value(value)
+		{
+			s_Live++;
+		}
+
+		~Node()
+		{
+			// Scribble over the value so a reader using a freed node would notice
+			Value=-1;
+			s_Live--;
+		}
+	};
+
+public:
+	TEST_METHOD(Construct)
+	{
+		using namespace Echo;
+
+		EpochManager manager;
+		EpochParticipant participant(manager);
+
+		Assert::AreEqual(1ULL,manager.Epoch());
+		Assert::IsFalse(participant.InCriticalSection());
+	}
+
+	TEST_METHOD(NestedCriticalSections)
+	{
+		using namespace Echo;
+
+		EpochManager manager;
+		EpochParticipant participant(manager);
+
+		{
+			EpochGuard outer(participant);
+			{
+				EpochGuard inner(participant);
+				Assert::IsTrue(participant.InCriticalSection());
+			}
+
+			Assert::IsTrue(participant.InCriticalSection());
+		}
+
+		Assert::IsFalse(participant.InCriticalSection());
+	}
+
+	TEST_METHOD(ReaderBlocksReclamation)
+	{
+		using namespace Echo;
+
+		Node::s_Live=0;
+
+		EpochManager manager;
+		EpochParticipant reader(manager);
+		EpochParticipant writer(manager, 1);
+
+		{
+			EpochGuard guard(reader);
+
+			writer.Retire(new Node(1));
+			manager.Reclaim();
+			manager.Reclaim();
+			manager.Reclaim();
+
+			// The reader entered before the node was retired, so it must survive
+			Assert::AreEqual(1,Node::s_Live.load());
+		}
+
+		manager.Reclaim();
+		manager.Reclaim();
+		manager.Reclaim();
+
+		Assert::AreEqual(0,Node::s_Live.load());
+	}
+
+	TEST_METHOD(BackgroundReclamation)
+	{
+		using namespace Echo;
+
+		Node::s_Live=0;
+
+		ImmediateWorkItemDispatcher dispatcher;
+		EpochManager manager(dispatcher);
+
+		{
+			EpochParticipant writer(manager, 4);
+
+			for(int i=0; i<100; i++)
+			{
+				writer.Retire(new Node(i));
+			}
+		}
+
+		manager.Reclaim();
+		manager.Reclaim();
+
+		Assert::AreEqual(0,Node::s_Live.load());
+		Assert::AreEqual((size_t)0,manager.PendingReclamation());
+	}
+
+	TEST_METHOD(ConcurrentReadersAndWriter)
+	{
+		using namespace Echo;
+
+		Node::s_Live=0;
+
+		EpochManager manager;
+		std::atomic<Node*> shared(new Node(0));
+		std::atomic<bool> stop(false);
+		std::atomic<bool> sawFreed(false);
+
+		std::vector<Thread> readers;
+		for(int i=0; i<4; i++)
+		{
+			readers.emplace_back([&]
+			{
+				EpochParticipant participant(manager);
+
+				while(!stop)
+				{
+					EpochGuard guard(participant);
+
+					Node *node=shared.load(std::memory_order_acquire);
+					if(node->Value<0) sawFreed=true;
+				}
+			});
+		}
+
+		for(auto &reader : readers) reader.Start();
+
+		{
+			EpochParticipant writer(manager, 16);
+
+			for(int i=1; i<=20000; i++)
+			{
+				Node *previous=shared.exchange(new Node(i), std::memory_order_acq_rel);
+				writer.Retire(previous);
+			}
+
+			stop=true;
+			for(auto &reader : readers) reader.Wait();
+		}
+
+		delete shared.load();
+
+		manager.Reclaim();
+		manager.Reclaim();
+
+		Assert::IsFalse(sawFreed);
+		Assert::AreEqual(0,Node::s_Live.load());
+	}
+};
+
+std::atomic<int> EpochTests::Node::s_Live(0);
+
+} // end of namespace
\ No newline at end of file
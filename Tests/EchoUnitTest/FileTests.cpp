@@ -4,6 +4,10 @@
 using namespace Microsoft::VisualStudio::CppUnitTestFramework;
 
 #include <Echo\File.h>
+#include <Echo\Buffer.h>
+#include <Echo\Environment.h>
+
+#include <cstring>
 
 namespace EchoUnitTest 
 {
@@ -17,6 +21,156 @@ public:
 
 		File file;
 	}
+
+	static tstd::tstring TempFilename()
+	{
+		TCHAR path[MAX_PATH]={};
+		TCHAR filename[MAX_PATH]={};
+
+		::GetTempPath(MAX_PATH,path);
+		::GetTempFileName(path,_T("ech"),0,filename);
+
+		return filename;
+	}
+
+	TEST_METHOD(WriteV_ReadV)
+	{
+		using namespace Echo;
+
+		auto filename=TempFilename();
+
+		{
+			auto file=File::Create(filename,GENERIC_WRITE);
+			ConstIoSegment segments[]={{"head",4},{"payload",7}};
+
+			Assert::AreEqual((DWORD)11,file.WriteV(segments,2));
+		}
+
+		{
+			auto file=File::OpenRead(filename);
+
+			char head[4]={};
+			char payload[16]={};
+			IoSegment segments[]={{head,4},{payload,sizeof(payload)}};
+
+			Assert::AreEqual((DWORD)11,file.ReadV(segments,2));
+			Assert::AreEqual(0,std::memcmp(head,"head",4));
+			Assert::AreEqual(0,std::memcmp(payload,"payload",7));
+		}
+
+		::DeleteFile(filename.c_str());
+	}
+
+	TEST_METHOD(WriteVAsync_Unaligned)
+	{
+		using namespace Echo;
+
+		auto filename=TempFilename();
+
+		{
+			// The segments aren't whole pages, so they are written one after another
+			auto file=File::CreateAsync(filename,GENERIC_WRITE);
+			ConstIoSegment segments[]={{"head",4},{"payload",7}};
+
+			OVERLAPPED overlapped={};
+			file.WriteVAsync(segments,2,overlapped);
+			Assert::AreEqual((DWORD)11,file.WaitForAsyncToComplete(overlapped));
+		}
+
+		{
+			auto file=File::OpenRead(filename);
+
+			char data[16]={};
+			Assert::AreEqual((DWORD)11,file.Read(data,sizeof(data)));
+			Assert::AreEqual(0,std::memcmp(data,"headpayload",11));
+		}
+
+		::DeleteFile(filename.c_str());
+	}
+
+	TEST_METHOD(ReadVAsync_EndOfFile)
+	{
+		using namespace Echo;
+
+		auto filename=TempFilename();
+
+		{
+			auto file=File::Create(filename,GENERIC_WRITE);
+			file.Write("headpayload",11);
+		}
+
+		{
+			// The second segment starts exactly at the end of the file
+			auto file=File::OpenReadAsync(filename);
+
+			char head[11]={};
+			char tail[5]={};
+			IoSegment segments[]={{head,11},{tail,5}};
+
+			OVERLAPPED overlapped={};
+			file.ReadVAsync(segments,2,overlapped);
+			Assert::AreEqual((DWORD)11,file.WaitForAsyncToComplete(overlapped));
+			Assert::AreEqual((DWORD)0,overlapped.Offset);
+			Assert::AreEqual(0,std::memcmp(head,"headpayload",11));
+		}
+
+		::DeleteFile(filename.c_str());
+	}
+
+	TEST_METHOD(ScatterGather)
+	{
+		using namespace Echo;
+
+		auto filename=TempFilename();
+		const DWORD pageSize=Environment::PageSize();
+
+		auto source=Buffer::ForIO(pageSize*3);
+		for(size_t i=0; i<source.Size(); i++) source.DataAs<BYTE>()[i]=static_cast<BYTE>(i*7);
+
+		auto pages=source.DataAs<BYTE>();
+
+		{
+			// Whole, page aligned pages on an unbuffered file go through WriteFileGather and ReadFileScatter
+			auto file=File::Open(filename,GENERIC_READ|GENERIC_WRITE,0,CREATE_ALWAYS,FILE_ATTRIBUTE_NORMAL|FILE_FLAG_OVERLAPPED|FILE_FLAG_NO_BUFFERING);
+
+			ConstIoSegment writes[]={{pages+pageSize*2,pageSize},{pages,pageSize},{pages+pageSize,pageSize}};
+
+			OVERLAPPED writeOverlapped={};
+			AsyncResult writeResult=AsyncResult::Pending;
+			Assert::IsTrue(file.TryWriteFileGather(writes,3,writeOverlapped,writeResult));
+			Assert::AreEqual(pageSize*3,file.WaitForAsyncToComplete(writeOverlapped));
+
+			auto destination=Buffer::ForIO(pageSize*3);
+			auto read=destination.DataAs<BYTE>();
+
+			IoSegment reads[]={{read,pageSize},{read+pageSize,pageSize},{read+pageSize*2,pageSize}};
+
+			OVERLAPPED readOverlapped={};
+			AsyncResult readResult=AsyncResult::Pending;
+			Assert::IsTrue(file.TryReadFileScatter(reads,3,readOverlapped,readResult));
+			Assert::AreEqual(pageSize*3,file.WaitForAsyncToComplete(readOverlapped));
+
+			Assert::AreEqual(0,std::memcmp(read,pages+pageSize*2,pageSize));
+			Assert::AreEqual(0,std::memcmp(read+pageSize,pages,pageSize));
+			Assert::AreEqual(0,std::memcmp(read+pageSize*2,pages+pageSize,pageSize));
+		}
+
+		{
+			// Without FILE_FLAG_NO_BUFFERING the gather is refused, and WriteVAsync has to write the pages one at a time
+			auto file=File::Open(filename,GENERIC_READ|GENERIC_WRITE,0,CREATE_ALWAYS,FILE_ATTRIBUTE_NORMAL|FILE_FLAG_OVERLAPPED);
+
+			ConstIoSegment writes[]={{pages,pageSize},{pages+pageSize,pageSize}};
+
+			OVERLAPPED overlapped={};
+			AsyncResult result=AsyncResult::Pending;
+			Assert::IsFalse(file.TryWriteFileGather(writes,2,overlapped,result));
+
+			file.WriteVAsync(writes,2,overlapped);
+			Assert::AreEqual(pageSize*2,file.WaitForAsyncToComplete(overlapped));
+		}
+
+		::DeleteFile(filename.c_str());
+	}
 };
 
 } // end of namespace
\ No newline at end of file
@@ -0,0 +1,105 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+#include <Echo\Latch.h>
+#include <Echo\ThreadPool.h>
+#include <Echo\Thread.h>
+
+#include <atomic>
+#include <vector>
+
+namespace EchoUnitTest 
+{
+
+TEST_CLASS(LatchTests)
+{
+public:
+	TEST_METHOD(Construct)
+	{
+		using namespace Echo;
+
+		Latch latch(3);
+		Assert::AreEqual(3L,latch.Count());
+		Assert::IsFalse(latch.IsSet());
+
+		Latch open(0);
+		Assert::IsTrue(open.IsSet());
+		Assert::IsTrue(open.Wait(std::chrono::milliseconds(0)));
+	}
+
+	TEST_METHOD(CountDown)
+	{
+		using namespace Echo;
+
+		Latch latch(3);
+		latch.CountDown(2);
+		Assert::IsFalse(latch.Wait(std::chrono::milliseconds(50)));
+
+		latch.CountDown();
+		Assert::IsTrue(latch.IsSet());
+		Assert::IsTrue(latch.Wait(std::chrono::milliseconds(0)));
+	}
+
+	TEST_METHOD(CountDown_TooFar)
+	{
+		using namespace Echo;
+
+		Latch latch(1);
+		Assert::ExpectException<ThreadException>([&]{latch.CountDown(2);});
+		Assert::AreEqual(1L,latch.Count());
+	}
+
+	TEST_METHOD(ForkJoin)
+	{
+		using namespace Echo;
+
+		const int count=1000;
+		std::atomic<int> ran(0);
+		Latch latch(count);
+
+		ThreadPool pool;
+		pool.Start();
+
+		for(int i=0; i<count; i++)
+		{
+			pool.Submit([&]
+			{
+				ran++;
+				latch.CountDown();
+			});
+		}
+
+		Assert::IsTrue(latch.Wait(std::chrono::seconds(10)));
+		Assert::AreEqual(count,ran.load());
+	}
+
+	TEST_METHOD(ArriveAndWait)
+	{
+		using namespace Echo;
+
+		const int threadCount=4;
+		Latch latch(threadCount,0);
+		std::atomic<int> arrived(0);
+		std::atomic<bool> early(false);
+
+		std::vector<Thread> threads;
+		for(int i=0; i<threadCount; i++)
+		{
+			threads.emplace_back([&]
+			{
+				arrived++;
+				latch.ArriveAndWait();
+				if(arrived.load()!=threadCount) early=true;
+			});
+		}
+
+		for(auto &thread : threads) thread.Start();
+		for(auto &thread : threads) thread.Wait();
+
+		Assert::IsFalse(early.load());
+	}
+};
+
+} // end of namespace
\ No newline at end of file
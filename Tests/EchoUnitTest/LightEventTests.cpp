@@ -0,0 +1,156 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+
+#include <atomic>
+#include <chrono>
+#include <vector>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+#include <Echo\LightEvent.h>
+#include <Echo\Thread.h>
+
+namespace EchoUnitTest 
+{
+
+TEST_CLASS(LightEventTests)
+{
+private:
+	std::chrono::milliseconds m_Zero;
+
+public:
+	LightEventTests()
+	{
+		m_Zero=std::chrono::milliseconds(0);
+	}
+
+	TEST_METHOD(ManualReset)
+	{
+		using namespace Echo;
+
+		ManualResetLightEvent event(InitialState::NonSignalled);
+
+		// It's not signalled, so wait will be false
+		bool signalled=event.Wait(m_Zero);
+		Assert::AreEqual(false,signalled,nullptr,LINE_INFO());
+
+		event.Set();
+		Assert::IsTrue(event.IsSet());
+
+		// It should stay set now
+		event.Wait();
+
+		signalled=event.Wait(m_Zero);
+		Assert::AreEqual(true,signalled,nullptr,LINE_INFO());
+
+		// Set it back to non-signalled
+		event.Reset();
+		signalled=event.Wait(m_Zero);
+		Assert::AreEqual(false,signalled,nullptr,LINE_INFO());
+	}
+
+	TEST_METHOD(AutoReset)
+	{
+		using namespace Echo;
+
+		AutoResetLightEvent event(InitialState::NonSignalled);
+
+		// It's not signalled, so wait will be false
+		bool signalled=event.Wait(m_Zero);
+		Assert::AreEqual(false,signalled,nullptr,LINE_INFO());
+
+		event.Set();
+
+		// It'll be set for one wait
+		event.Wait();
+
+		signalled=event.Wait(m_Zero);
+		Assert::AreEqual(false,signalled,nullptr,LINE_INFO());
+	}
+
+	TEST_METHOD(InitiallySignalled)
+	{
+		using namespace Echo;
+
+		ManualResetLightEvent manual(InitialState::Signalled);
+		Assert::IsTrue(manual.Wait(m_Zero));
+
+		AutoResetLightEvent automatic(InitialState::Signalled);
+		Assert::IsTrue(automatic.Wait(m_Zero));
+		Assert::IsFalse(automatic.Wait(m_Zero));
+	}
+
+	TEST_METHOD(Timeout)
+	{
+		using namespace Echo;
+
+		AutoResetLightEvent event(InitialState::NonSignalled);
+
+		auto start=std::chrono::steady_clock::now();
+		Assert::IsFalse(event.Wait(std::chrono::milliseconds(100)));
+
+		auto elapsed=std::chrono::steady_clock::now()-start;
+		Assert::IsTrue(elapsed>=std::chrono::milliseconds(90));
+	}
+
+	TEST_METHOD(ManualReleasesAllWaiters)
+	{
+		using namespace Echo;
+
+		ManualResetLightEvent event(InitialState::NonSignalled, 0);
+		std::atomic<int> released(0);
+
+		std::vector<Thread> threads;
+		for(int i=0; i<4; i++)
+		{
+			threads.emplace_back([&]
+			{
+				event.Wait();
+				released++;
+			});
+		}
+
+		for(auto &thread : threads) thread.Start();
+
+		::Sleep(100);
+		Assert::AreEqual(0,released.load());
+
+		event.Set();
+		for(auto &thread : threads) thread.Wait();
+
+		Assert::AreEqual(4,released.load());
+	}
+
+	TEST_METHOD(PingPong)
+	{
+		using namespace Echo;
+
+		AutoResetLightEvent ping(InitialState::NonSignalled);
+		AutoResetLightEvent pong(InitialState::NonSignalled);
+
+		const int iterations=100000;
+
+		Thread thread([&]
+		{
+			for(int i=0; i<iterations; i++)
+			{
+				ping.Wait();
+				pong.Set();
+			}
+		});
+
+		thread.Start();
+
+		for(int i=0; i<iterations; i++)
+		{
+			ping.Set();
+			pong.Wait();
+		}
+
+		thread.Wait();
+		Assert::IsFalse(ping.IsSet());
+		Assert::IsFalse(pong.IsSet());
+	}
+};
+
+} // end of namespace
\ No newline at end of file
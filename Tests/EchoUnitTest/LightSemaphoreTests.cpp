@@ -0,0 +1,172 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+#include <Echo\LightSemaphore.h>
+#include <Echo\Thread.h>
+
+#include <atomic>
+#include <vector>
+
+namespace EchoUnitTest 
+{
+
+TEST_CLASS(LightSemaphoreTests)
+{
+private:
+	Echo::UniqueGuard<Echo::LightSemaphore> CreateGuard(Echo::LightSemaphore &semaphore)
+	{
+		using namespace Echo;
+		
+		UniqueGuard<LightSemaphore> guard(semaphore, 2);
+		return guard;
+	}
+
+public:
+	TEST_METHOD(Construct)
+	{
+		using namespace Echo;
+
+		LightSemaphore semaphore(10);
+		Assert::AreEqual(10L,semaphore.Count());
+		Assert::AreEqual(10L,semaphore.MaximumCount());
+	}
+
+	TEST_METHOD(Construct_BadCounts)
+	{
+		using namespace Echo;
+
+		Assert::ExpectException<ArgumentException>([]{LightSemaphore semaphore(0,0);});
+		Assert::ExpectException<ArgumentException>([]{LightSemaphore semaphore(11,10);});
+	}
+
+	TEST_METHOD(Release)
+	{
+		using namespace Echo;
+
+		LightSemaphore semaphore(1,10);
+		Assert::AreEqual(1L,semaphore.Release(3));
+		Assert::AreEqual(4L,semaphore.Count());
+	}
+
+	TEST_METHOD(Release_TooMany)
+	{
+		using namespace Echo;
+
+		LightSemaphore semaphore(9,10);
+		Assert::ExpectException<ThreadException>([&]{semaphore.Release(2);});
+		Assert::AreEqual(9L,semaphore.Count());
+	}
+
+	TEST_METHOD(TryAcquire)
+	{
+		using namespace Echo;
+
+		LightSemaphore semaphore(3,10);
+		Assert::IsTrue(semaphore.TryAcquire(2));
+		Assert::IsFalse(semaphore.TryAcquire(2));
+		Assert::IsTrue(semaphore.TryAcquire());
+		Assert::AreEqual(0L,semaphore.Count());
+	}
+
+	TEST_METHOD(UseGuard)
+	{
+		using namespace Echo;
+
+		LightSemaphore semaphore(5,10);
+
+		{
+			Guard<LightSemaphore> guard(semaphore, 3);
+			Assert::AreEqual(2L,semaphore.Count());
+		}
+
+		Assert::AreEqual(5L,semaphore.Count());
+	}
+
+	TEST_METHOD(UseUniqueGuard)
+	{
+		using namespace Echo;
+
+		LightSemaphore semaphore(5,10);
+
+		{
+			auto guard=CreateGuard(semaphore);
+			Assert::AreEqual(3L,semaphore.Count());
+		}
+
+		Assert::AreEqual(5L,semaphore.Count());
+	}
+
+	TEST_METHOD(NothingAvailable)
+	{
+		using namespace Echo;
+
+		LightSemaphore semaphore(1,10);
+		Assert::IsFalse(semaphore.Acquire(2,std::chrono::milliseconds(100)));
+		Assert::AreEqual(1L,semaphore.Count());
+	}
+
+	TEST_METHOD(BlockedUntilReleased)
+	{
+		using namespace Echo;
+
+		LightSemaphore semaphore(0,10,0);
+		std::atomic<bool> acquired(false);
+
+		Thread thread([&]
+		{
+			semaphore.Acquire(3);
+			acquired=true;
+		});
+
+		thread.Start();
+
+		semaphore.Release(2);
+		::Sleep(100);
+		Assert::IsFalse(acquired.load());
+
+		semaphore.Release();
+		thread.Wait();
+		Assert::IsTrue(acquired.load());
+		Assert::AreEqual(0L,semaphore.Count());
+	}
+
+	TEST_METHOD(Throttling)
+	{
+		using namespace Echo;
+
+		const LONG permits=3;
+		LightSemaphore semaphore(permits);
+		std::atomic<LONG> active(0);
+		std::atomic<LONG> peak(0);
+
+		std::vector<Thread> threads;
+		for(int i=0; i<8; i++)
+		{
+			threads.emplace_back([&]
+			{
+				for(int j=0; j<10000; j++)
+				{
+					LightSemaphoreGuard guard(semaphore);
+
+					LONG now=++active;
+					LONG seen=peak.load();
+					while(now>seen && !peak.compare_exchange_weak(seen,now))
+					{
+					}
+
+					--active;
+				}
+			});
+		}
+
+		for(auto &thread : threads) thread.Start();
+		for(auto &thread : threads) thread.Wait();
+
+		Assert::IsTrue(peak.load()<=permits);
+		Assert::AreEqual(permits,semaphore.Count());
+	}
+};
+
+} // end of namespace
\ No newline at end of file
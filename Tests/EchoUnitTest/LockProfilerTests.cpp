@@ -0,0 +1,136 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+#include <Echo\LockProfiler.h>
+#include <Echo\Thread.h>
+
+#include <algorithm>
+#include <vector>
+
+namespace EchoUnitTest 
+{
+
+TEST_CLASS(LockProfilerTests)
+{
+private:
+	static Echo::LockSiteReport Find(const tstd::tstring &name)
+	{
+		using namespace Echo;
+
+		auto reports=LockProfiler::Snapshot();
+		auto it=std::find_if(reports.begin(), reports.end(), [&](const LockSiteReport &report){return report.Name==name;});
+
+		Assert::IsTrue(it!=reports.end());
+		return *it;
+	}
+
+public:
+	TEST_METHOD(CriticalSectionAcquisitions)
+	{
+		using namespace Echo;
+
+		static LockSite site(_T("LockProfilerTests::CriticalSectionAcquisitions"));
+		ProfiledCriticalSection section(site);
+
+		{
+			Guard<ProfiledCriticalSection> lock(section);
+		}
+
+		{
+			TryGuard<ProfiledCriticalSection> lock(section);
+			Assert::IsTrue(lock.IsLocked());
+		}
+
+		auto report=Find(_T("LockProfilerTests::CriticalSectionAcquisitions"));
+		Assert::AreEqual(2ULL,report.Acquisitions);
+		Assert::AreEqual(0ULL,report.ContendedAcquisitions);
+	}
+
+	TEST_METHOD(RecursiveCriticalSection)
+	{
+		using namespace Echo;
+
+		static LockSite site(_T("LockProfilerTests::RecursiveCriticalSection"));
+		ProfiledCriticalSection section(site);
+
+		{
+			Guard<ProfiledCriticalSection> outer(section);
+			Guard<ProfiledCriticalSection> inner(section);
+		}
+
+		auto report=Find(_T("LockProfilerTests::RecursiveCriticalSection"));
+		Assert::AreEqual(2ULL,report.Acquisitions);
+	}
+
+	TEST_METHOD(ReadWriteLockShared)
+	{
+		using namespace Echo;
+
+		static LockSite site(_T("LockProfilerTests::ReadWriteLockShared"));
+		ProfiledReadWriteLock rwLock(site);
+
+		{
+			ProfiledLockSharedGuard<ReadWriteLock> first(rwLock);
+			ProfiledLockSharedGuard<ReadWriteLock> second(rwLock);
+		}
+
+		{
+			auto guard=UniqueGuard<ProfiledReadWriteLock>(rwLock);
+		}
+
+		auto report=Find(_T("LockProfilerTests::ReadWriteLockShared"));
+		Assert::AreEqual(3ULL,report.Acquisitions);
+	}
+
+	TEST_METHOD(MutexAcquisitions)
+	{
+		using namespace Echo;
+
+		static LockSite site(_T("LockProfilerTests::Mutex"));
+		ProfiledMutex mutex(site, Ownership::NotOwned);
+
+		{
+			Guard<ProfiledMutex> lock(mutex);
+		}
+
+		auto report=Find(_T("LockProfilerTests::Mutex"));
+		Assert::AreEqual(1ULL,report.Acquisitions);
+	}
+
+	TEST_METHOD(ContentionFromExitedThreads)
+	{
+		using namespace Echo;
+
+		static LockSite site(_T("LockProfilerTests::ContentionFromExitedThreads"));
+		ProfiledCriticalSection section(site);
+
+		const int threadCount=4;
+		const int iterations=10000;
+
+		std::vector<Thread> threads;
+		for(int i=0; i<threadCount; i++)
+		{
+			threads.emplace_back([&]
+			{
+				for(int j=0; j<iterations; j++)
+				{
+					Guard<ProfiledCriticalSection> lock(section);
+				}
+			});
+		}
+
+		for(auto &thread : threads) thread.Start();
+		for(auto &thread : threads) thread.Wait();
+
+		auto report=Find(_T("LockProfilerTests::ContentionFromExitedThreads"));
+		Assert::AreEqual((ULONG64)threadCount*iterations,report.Acquisitions);
+		Assert::IsTrue(report.ContendedAcquisitions<=report.Acquisitions);
+
+		auto text=LockProfiler::Dump();
+		Assert::IsTrue(text.find(_T("LockProfilerTests::ContentionFromExitedThreads"))!=tstd::tstring::npos);
+	}
+};
+
+} // end of namespace
\ No newline at end of file
@@ -16,6 +16,25 @@ public:
 		using namespace Echo;
 
 		MemoryMappedFile file;
+		Assert::IsTrue(file.Pages()==PageMode::Standard);
+	}
+
+	TEST_METHOD(InMemoryLargePages)
+	{
+		using namespace Echo;
+
+		// Falls back to standard pages if the process can't use large pages
+		auto file=MemoryMappedFile::InMemory(1024*1024,PAGE_READWRITE,PageMode::Large);
+		Assert::IsTrue(file.Pages()==(LargePages::IsAvailable() ? PageMode::Large : PageMode::Standard));
+
+		SIZE_T size=(file.Pages()==PageMode::Large ? LargePages::RoundUp(1024*1024) : 1024*1024);
+		auto data=file.MapAs<BYTE>(0,size,FILE_MAP_WRITE);
+
+		data[0]=1;
+		data[size-1]=2;
+		Assert::AreEqual((BYTE)2,data[size-1]);
+
+		file.Unmap(data);
 	}
 };
 
@@ -0,0 +1,119 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+#include <Echo\MirroredRingBuffer.h>
+#include <Echo\ByteBuffer.h>
+
+#include <cstring>
+#include <vector>
+
+namespace EchoUnitTest 
+{
+
+TEST_CLASS(MirroredRingBufferTests)
+{
+public:
+	TEST_METHOD(Construct)
+	{
+		using namespace Echo;
+
+		MirroredRingBuffer ring(100);
+		Assert::AreEqual((size_t)Environment::AllocationGranularity(),ring.Capacity());
+		Assert::AreEqual((size_t)0,ring.Size());
+		Assert::AreEqual(ring.Capacity(),ring.Free());
+		Assert::IsTrue(ring.IsEmpty());
+		Assert::IsFalse(ring.IsFull());
+	}
+
+	TEST_METHOD(Mirrored)
+	{
+		using namespace Echo;
+
+		MirroredRingBuffer ring(1);
+		auto data=static_cast<BYTE*>(ring.WriteRegion());
+
+		// Both views map the same pages
+		data[0]=42;
+		Assert::AreEqual((BYTE)42,data[ring.Capacity()]);
+
+		data[ring.Capacity()+1]=43;
+		Assert::AreEqual((BYTE)43,data[1]);
+	}
+
+	TEST_METHOD(WrapAround)
+	{
+		using namespace Echo;
+
+		MirroredRingBuffer ring(1);
+		const size_t capacity=ring.Capacity();
+
+		std::vector<BYTE> filler(capacity-10,0);
+		ring.Write(filler.data(),filler.size());
+		ring.Consume(filler.size());
+
+		// This record straddles the end of the ring but reads back contiguously
+		const char record[]="a record that wraps";
+		Assert::AreEqual(sizeof(record),ring.Write(record,sizeof(record)));
+
+		Assert::AreEqual(sizeof(record),ring.Size());
+		Assert::AreEqual(0,std::memcmp(record,ring.ReadRegion(),sizeof(record)));
+		Assert::AreEqual(capacity-sizeof(record),ring.Free());
+
+		char copy[sizeof(record)];
+		Assert::AreEqual(sizeof(record),ring.Read(copy,sizeof(copy)));
+		Assert::AreEqual(0,std::memcmp(record,copy,sizeof(record)));
+		Assert::IsTrue(ring.IsEmpty());
+	}
+
+	TEST_METHOD(Full)
+	{
+		using namespace Echo;
+
+		MirroredRingBuffer ring(1);
+		std::vector<BYTE> data(ring.Capacity()+100,1);
+
+		Assert::AreEqual(ring.Capacity(),ring.Write(data.data(),data.size()));
+		Assert::IsTrue(ring.IsFull());
+		Assert::AreEqual((size_t)0,ring.Write(data.data(),1));
+	}
+
+	TEST_METHOD(CommitAndConsume)
+	{
+		using namespace Echo;
+
+		MirroredRingBuffer ring(1);
+
+		std::memcpy(ring.WriteRegion(),"hello",5);
+		ring.Commit(5);
+		Assert::AreEqual((size_t)5,ring.Size());
+
+		ring.Consume(2);
+		Assert::AreEqual(0,std::memcmp("llo",ring.ReadRegion(),3));
+
+		Assert::ExpectException<ArgumentException>([&ring]{ring.Consume(4);});
+		Assert::ExpectException<ArgumentException>([&ring]{ring.Commit(ring.Free()+1);});
+	}
+
+	TEST_METHOD(FillAndDrain)
+	{
+		using namespace Echo;
+
+		ByteBuffer source;
+		for(int i=0; i<1000; i++) source.AppendValue(i);
+
+		MirroredRingBuffer ring(1);
+		Assert::AreEqual((DWORD)source.Size(),ring.FillFrom(source));
+		Assert::AreEqual((DWORD)0,ring.FillFrom(source));
+
+		Assert::AreEqual(999,ring.ReadRegionAs<int>()[999]);
+
+		ByteBuffer destination;
+		Assert::AreEqual((DWORD)source.Size(),ring.DrainTo(destination));
+		Assert::IsTrue(ring.IsEmpty());
+		Assert::AreEqual(0,std::memcmp(source.Data(),destination.Data(),source.Size()));
+	}
+};
+
+} // end of namespace
\ No newline at end of file
@@ -0,0 +1,125 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+#include <Echo\MonotonicArena.h>
+
+#include <cstdint>
+#include <vector>
+
+namespace EchoUnitTest 
+{
+
+TEST_CLASS(MonotonicArenaTests)
+{
+public:
+	TEST_METHOD(Lazy)
+	{
+		using namespace Echo;
+
+		MonotonicArena arena;
+		Assert::AreEqual((size_t)0,arena.Capacity());
+	}
+
+	TEST_METHOD(Allocate)
+	{
+		using namespace Echo;
+
+		MonotonicArena arena(256);
+
+		char *first=static_cast<char*>(arena.Allocate(10,1));
+		char *second=static_cast<char*>(arena.Allocate(10,1));
+
+		// Consecutive allocations are pointer bumps
+		Assert::IsTrue(second==first+10);
+		Assert::AreEqual((size_t)20,arena.BytesAllocated());
+	}
+
+	TEST_METHOD(Alignment)
+	{
+		using namespace Echo;
+
+		MonotonicArena arena(256);
+		arena.Allocate(1,1);
+
+		void *aligned=arena.Allocate(8,64);
+		Assert::AreEqual((uintptr_t)0,reinterpret_cast<uintptr_t>(aligned) & 63);
+
+		Assert::ExpectException<ArgumentException>([&]{arena.Allocate(8,3);});
+	}
+
+	TEST_METHOD(Growth)
+	{
+		using namespace Echo;
+
+		MonotonicArena arena(256);
+
+		for(int i=0; i<100; i++) arena.Allocate(100);
+		Assert::IsTrue(arena.Capacity()>=10000);
+
+		// A request bigger than a block gets a block of its own
+		arena.Allocate(1024*1024);
+		Assert::IsTrue(arena.Capacity()>=1024*1024);
+	}
+
+	TEST_METHOD(ResetKeepsLastBlock)
+	{
+		using namespace Echo;
+
+		MonotonicArena arena(256);
+		for(int i=0; i<100; i++) arena.Allocate(100);
+
+		arena.Reset();
+		Assert::AreEqual((size_t)0,arena.BytesAllocated());
+
+		size_t capacity=arena.Capacity();
+		Assert::IsTrue(capacity>0);
+
+		// A batch that fits in the kept block doesn't grow the arena
+		for(int i=0; i<10; i++) arena.Allocate(100);
+		Assert::AreEqual(capacity,arena.Capacity());
+
+		arena.Release();
+		Assert::AreEqual((size_t)0,arena.Capacity());
+	}
+
+	TEST_METHOD(Scope)
+	{
+		using namespace Echo;
+
+		MonotonicArena outer;
+		MonotonicArena inner;
+
+		Assert::IsNull(MonotonicArena::Current());
+
+		{
+			ArenaScope outerScope(outer);
+			Assert::IsTrue(MonotonicArena::Current()==&outer);
+
+			{
+				ArenaScope innerScope(inner);
+				Assert::IsTrue(MonotonicArena::Current()==&inner);
+			}
+
+			Assert::IsTrue(MonotonicArena::Current()==&outer);
+		}
+
+		Assert::IsNull(MonotonicArena::Current());
+	}
+
+	TEST_METHOD(Container)
+	{
+		using namespace Echo;
+
+		MonotonicArena arena;
+		std::vector<int, ArenaAllocator<int>> values{ArenaAllocator<int>(arena)};
+
+		for(int i=0; i<1000; i++) values.push_back(i);
+
+		Assert::AreEqual(999,values.back());
+		Assert::IsTrue(arena.BytesAllocated()>=1000*sizeof(int));
+	}
+};
+
+} // end of namespace
\ No newline at end of file
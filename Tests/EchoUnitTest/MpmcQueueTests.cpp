@@ -0,0 +1,133 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+#include <Echo\MpmcQueue.h>
+#include <Echo\Thread.h>
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace EchoUnitTest 
+{
+
+TEST_CLASS(MpmcQueueTests)
+{
+public:
+	TEST_METHOD(Construct)
+	{
+		using namespace Echo;
+
+		MpmcQueue<int> queue(10);
+		Assert::AreEqual((size_t)16,queue.Capacity());
+		Assert::AreEqual((size_t)0,queue.Size());
+	}
+
+	TEST_METHOD(TryEnqueueDequeue)
+	{
+		using namespace Echo;
+
+		MpmcQueue<std::string> queue(2);
+		Assert::IsTrue(queue.TryEnqueue(std::string("one")));
+		Assert::IsTrue(queue.TryEnqueue(std::string("two")));
+		Assert::IsFalse(queue.TryEnqueue(std::string("three")));
+		Assert::AreEqual((size_t)2,queue.Size());
+
+		std::string value;
+		Assert::IsTrue(queue.TryDequeue(value));
+		Assert::AreEqual(std::string("one"),value);
+		Assert::IsTrue(queue.TryDequeue(value));
+		Assert::AreEqual(std::string("two"),value);
+		Assert::IsFalse(queue.TryDequeue(value));
+
+		// The cells are reused on the next lap
+		Assert::IsTrue(queue.TryEnqueue(std::string("four")));
+		Assert::IsTrue(queue.TryDequeue(value));
+		Assert::AreEqual(std::string("four"),value);
+	}
+
+	TEST_METHOD(Timeouts)
+	{
+		using namespace Echo;
+
+		MpmcQueue<int> queue(2);
+		int value=0;
+
+		Assert::IsFalse(queue.Dequeue(value,std::chrono::milliseconds(50)));
+
+		queue.Enqueue(1);
+		queue.Enqueue(2);
+		Assert::IsFalse(queue.Enqueue(3,std::chrono::milliseconds(50)));
+	}
+
+	TEST_METHOD(MoveOnly)
+	{
+		using namespace Echo;
+
+		MpmcQueue<std::unique_ptr<int>> queue(4);
+		Assert::IsTrue(queue.TryEnqueue(std::unique_ptr<int>(new int(42))));
+
+		std::unique_ptr<int> value;
+		Assert::IsTrue(queue.TryDequeue(value));
+		Assert::AreEqual(42,*value);
+	}
+
+	TEST_METHOD(ManyProducersManyConsumers)
+	{
+		using namespace Echo;
+
+		const unsigned producerCount=4;
+		const unsigned consumerCount=4;
+		const unsigned perProducer=100000;
+
+		// Small enough that producers and consumers both end up parking
+		MpmcQueue<unsigned> queue(64);
+		std::atomic<unsigned long long> sum(0);
+		std::atomic<unsigned> received(0);
+
+		std::vector<std::unique_ptr<Thread>> threads;
+
+		for(unsigned p=0; p<producerCount; p++)
+		{
+			threads.emplace_back(new Thread([&queue,p,perProducer]
+			{
+				for(unsigned i=0; i<perProducer; i++)
+				{
+					queue.Enqueue(p*perProducer+i+1);
+				}
+			}));
+		}
+
+		for(unsigned c=0; c<consumerCount; c++)
+		{
+			threads.emplace_back(new Thread([&]
+			{
+				unsigned value=0;
+
+				// Zero is the signal to stop
+				for(queue.Dequeue(value); value!=0; queue.Dequeue(value))
+				{
+					sum+=value;
+					received++;
+				}
+			}));
+		}
+
+		for(auto &thread : threads) thread->Start();
+		for(unsigned p=0; p<producerCount; p++) threads[p]->Wait();
+
+		for(unsigned c=0; c<consumerCount; c++) queue.Enqueue(0u);
+		for(auto &thread : threads) thread->Wait();
+
+		const unsigned long long total=producerCount*perProducer;
+		Assert::AreEqual(static_cast<unsigned>(total),received.load());
+		Assert::AreEqual(total*(total+1)/2,sum.load());
+		Assert::AreEqual((size_t)0,queue.Size());
+	}
+};
+
+} // end of namespace
\ No newline at end of file
@@ -81,6 +81,87 @@ public:
 		int signalledIndex=waiter.WaitAny(std::chrono::milliseconds(100));
 		Assert::AreEqual(-1,signalledIndex);
 	}
+
+	TEST_METHOD(WaitAnyAll_SomeSet)
+	{
+		using namespace Echo;
+
+		ManualResetEvent event1(InitialState::NonSignalled);
+		ManualResetEvent event2(InitialState::Signalled);
+		ManualResetEvent event3(InitialState::NonSignalled);
+		ManualResetEvent event4(InitialState::Signalled);
+
+		MultiWaiter waiter;
+		waiter << event1 << event2 << event3 << event4;
+
+		auto signalled=waiter.WaitAnyAll(std::chrono::milliseconds(100));
+		Assert::AreEqual((size_t)2,signalled.size());
+		Assert::AreEqual(1,signalled[0]);
+		Assert::AreEqual(3,signalled[1]);
+	}
+
+	TEST_METHOD(WaitAnyAll_NoneSet)
+	{
+		using namespace Echo;
+
+		ManualResetEvent event1(InitialState::NonSignalled);
+		ManualResetEvent event2(InitialState::NonSignalled);
+
+		MultiWaiter waiter;
+		waiter << event1 << event2;
+
+		auto signalled=waiter.WaitAnyAll(std::chrono::milliseconds(100));
+		Assert::IsTrue(signalled.empty());
+	}
+
+	TEST_METHOD(WaitAnyAll_RoundRobin)
+	{
+		using namespace Echo;
+
+		ManualResetEvent event1(InitialState::Signalled);
+		ManualResetEvent event2(InitialState::Signalled);
+		ManualResetEvent event3(InitialState::Signalled);
+
+		MultiWaiter waiter;
+		waiter << event1 << event2 << event3;
+
+		// Everything is serviced, so the next call starts back at the first handle
+		auto signalled=waiter.WaitAnyAll(std::chrono::milliseconds(100));
+		Assert::AreEqual((size_t)3,signalled.size());
+		Assert::AreEqual((size_t)0,waiter.NextStart());
+
+		event3.Reset();
+
+		// Only the first two are serviced, so the third handle goes first next time
+		signalled=waiter.WaitAnyAll(std::chrono::milliseconds(100));
+		Assert::AreEqual((size_t)2,signalled.size());
+		Assert::AreEqual((size_t)2,waiter.NextStart());
+
+		event3.Set();
+
+		signalled=waiter.WaitAnyAll(std::chrono::milliseconds(100));
+		Assert::AreEqual((size_t)3,signalled.size());
+		Assert::AreEqual(2,signalled[0]);
+		Assert::AreEqual(0,signalled[1]);
+		Assert::AreEqual(1,signalled[2]);
+	}
+
+	TEST_METHOD(WaitAnyAll_ConsumesAutoReset)
+	{
+		using namespace Echo;
+
+		AutoResetEvent event1(InitialState::Signalled);
+		AutoResetEvent event2(InitialState::Signalled);
+
+		MultiWaiter waiter;
+		waiter << event1 << event2;
+
+		auto signalled=waiter.WaitAnyAll(std::chrono::milliseconds(100));
+		Assert::AreEqual((size_t)2,signalled.size());
+
+		signalled=waiter.WaitAnyAll(std::chrono::milliseconds(0));
+		Assert::IsTrue(signalled.empty());
+	}
 };
 
 } // end of namespace
\ No newline at end of file
@@ -0,0 +1,178 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+#include <Echo\ObjectPool.h>
+#include <Echo\MpmcQueue.h>
+#include <Echo\WorkDispatchQueue.h>
+#include <Echo\ImmediateWorkItemDispatcher.h>
+#include <Echo\Thread.h>
+
+#include <string>
+#include <vector>
+
+namespace EchoUnitTest 
+{
+
+struct PooledMessage
+{
+	static int Live;
+
+	std::string Text;
+	int Id;
+
+	PooledMessage(const std::string &text, int id) : Text(text), Id(id)
+	{
+		Live++;
+	}
+
+	~PooledMessage()
+	{
+		Live--;
+	}
+};
+
+int PooledMessage::Live=0;
+
+TEST_CLASS(ObjectPoolTests)
+{
+public:
+	TEST_METHOD(Make)
+	{
+		using namespace Echo;
+
+		ObjectPool<PooledMessage> pool;
+
+		{
+			auto message=pool.Make("hello",42);
+			Assert::AreEqual(std::string("hello"),message->Text);
+			Assert::AreEqual(42,message->Id);
+			Assert::AreEqual(1,PooledMessage::Live);
+		}
+
+		Assert::AreEqual(0,PooledMessage::Live);
+	}
+
+	TEST_METHOD(Preallocate)
+	{
+		using namespace Echo;
+
+		ObjectPool<PooledMessage> pool(100);
+		size_t capacity=pool.Capacity();
+		Assert::IsTrue(capacity>=100);
+
+		std::vector<ObjectPool<PooledMessage>::Pointer> messages;
+		for(int i=0; i<100; i++) messages.push_back(pool.Make("x",i));
+
+		Assert::AreEqual(capacity,pool.Capacity());
+	}
+
+	TEST_METHOD(StorageIsReused)
+	{
+		using namespace Echo;
+
+		ObjectPool<PooledMessage> pool;
+
+		for(int round=0; round<10; round++)
+		{
+			std::vector<ObjectPool<PooledMessage>::Pointer> messages;
+			for(int i=0; i<200; i++) messages.push_back(pool.Make("x",i));
+		}
+
+		// Only the first round should have needed to grow the pool
+		Assert::IsTrue(pool.Capacity()<400);
+	}
+
+	TEST_METHOD(CrossThreadDestroy)
+	{
+		using namespace Echo;
+
+		ObjectPool<PooledMessage> pool;
+		MpmcQueue<ObjectPool<PooledMessage>::Pointer> queue(64);
+		const int count=100000;
+
+		Thread producer([&]
+		{
+			for(int i=0; i<count; i++) queue.Enqueue(pool.Make("message",i));
+		});
+
+		int received=0;
+		bool inOrder=true;
+
+		Thread consumer([&]
+		{
+			ObjectPool<PooledMessage>::Pointer message;
+
+			for(int i=0; i<count; i++)
+			{
+				queue.Dequeue(message);
+				if(message->Id!=received++) inOrder=false;
+
+				// Freed on this thread, so it travels back to the producer through the depot
+				message.reset();
+			}
+		});
+
+		producer.Start();
+		consumer.Start();
+		producer.Wait();
+		consumer.Wait();
+
+		Assert::AreEqual(count,received);
+		Assert::IsTrue(inOrder);
+		Assert::AreEqual(0,PooledMessage::Live);
+		Assert::IsTrue(pool.Capacity()<1000);
+	}
+
+	TEST_METHOD(ThroughWorkDispatchQueue)
+	{
+		using namespace Echo;
+
+		typedef ObjectPool<PooledMessage>::Pointer MessagePointer;
+
+		// Takes ownership of each message and lets it go back to the pool
+		class MessageQueue : public WorkDispatchQueue<MessagePointer>
+		{
+		private:
+			int &m_Total;
+
+		protected:
+			void ProcessItem(MessagePointer &message) override
+			{
+				m_Total+=message->Id;
+				message.reset();
+			}
+
+		public:
+			MessageQueue(IFunctionDispatcher &dispatcher, int &total) : WorkDispatchQueue(dispatcher), m_Total(total)
+			{
+			}
+		};
+
+		ObjectPool<PooledMessage> pool;
+		ImmediateWorkItemDispatcher dispatcher;
+		int total=0;
+
+		{
+			MessageQueue queue(dispatcher, total);
+
+			auto first=pool.Make("first",1);
+			queue.Enqueue(std::move(first));
+			Assert::IsTrue(first==nullptr);
+
+			Assert::IsTrue(queue.TryEnqueue(pool.Make("second",2)));
+
+			queue.Shutdown();
+
+			auto third=pool.Make("third",4);
+			Assert::IsFalse(queue.TryEnqueue(std::move(third)));
+			Assert::IsTrue(third!=nullptr);
+		}
+
+		Assert::AreEqual(3,total);
+		Assert::AreEqual(0,PooledMessage::Live);
+	}
+};
+
+} // end of namespace
\ No newline at end of file
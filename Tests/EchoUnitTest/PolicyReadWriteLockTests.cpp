@@ -0,0 +1,272 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+#include <Echo\PolicyReadWriteLock.h>
+#include <Echo\ConditionalVariable.h>
+#include <Echo\Thread.h>
+
+#include <atomic>
+#include <utility>
+#include <vector>
+
+namespace EchoUnitTest 
+{
+
+TEST_CLASS(PolicyReadWriteLockTests)
+{
+private:
+	template<typename POLICY>
+	static Echo::UniqueGuard<Echo::PolicyReadWriteLock<POLICY>> CreateGuard(Echo::PolicyReadWriteLock<POLICY> &lock)
+	{
+		using namespace Echo;
+		
+		UniqueGuard<PolicyReadWriteLock<POLICY>> guard(lock);
+		return guard;
+	}
+
+	template<typename POLICY>
+	static void CheckExclusion()
+	{
+		using namespace Echo;
+
+		PolicyReadWriteLock<POLICY> lock;
+
+		Assert::IsTrue(lock.TryEnterShared());
+		Assert::IsTrue(lock.TryEnterShared());
+		Assert::IsFalse(lock.TryEnter());
+		lock.ExitShared();
+		lock.ExitShared();
+
+		Assert::IsTrue(lock.TryEnter());
+		Assert::IsFalse(lock.TryEnterShared());
+		Assert::IsFalse(lock.TryEnterUpgradeable());
+		lock.Exit();
+	}
+
+	/**
+	 * Keeps the lock permanently read held by overlapping readers and checks a writer still gets in
+	 */
+	template<typename POLICY>
+	static void CheckWriterUnderReadSaturation()
+	{
+		using namespace Echo;
+
+		PolicyReadWriteLock<POLICY> lock;
+		std::atomic<bool> stop(false);
+		std::atomic<long> writes(0);
+
+		std::vector<Thread> readers;
+		for(int i=0; i<4; i++)
+		{
+			readers.emplace_back([&]
+			{
+				while(stop.load() == false)
+				{
+					PolicyReadWriteLockSharedGuard<POLICY> guard(lock);
+					::Sleep(1);
+				}
+			});
+		}
+
+		for(auto &reader : readers) reader.Start();
+
+		Thread writer([&]
+		{
+			for(int i=0; i<10; i++)
+			{
+				Guard<PolicyReadWriteLock<POLICY>> guard(lock);
+				writes++;
+			}
+		});
+
+		writer.Start();
+		bool finished = writer.Wait(std::chrono::seconds(10));
+
+		stop = true;
+		for(auto &reader : readers) reader.Wait();
+
+		Assert::IsTrue(finished);
+		Assert::AreEqual(10L, writes.load());
+	}
+
+public:
+	TEST_METHOD(Construct)
+	{
+		using namespace Echo;
+
+		ReaderPreferringReadWriteLock readerPreferring;
+		WriterPreferringReadWriteLock writerPreferring;
+		PhaseFairReadWriteLock phaseFair;
+	}
+
+	TEST_METHOD(Locking)
+	{
+		using namespace Echo;
+
+		PhaseFairReadWriteLock lock;
+		Guard<PhaseFairReadWriteLock> guard(lock);
+	}
+
+	TEST_METHOD(SharedLocking)
+	{
+		using namespace Echo;
+
+		PhaseFairReadWriteLock lock;
+		PolicyReadWriteLockSharedGuard<PhaseFairPolicy> guard1(lock);
+		PolicyReadWriteLockSharedGuard<PhaseFairPolicy> guard2(lock);
+	}
+
+	TEST_METHOD(UniqueLocking)
+	{
+		using namespace Echo;
+
+		WriterPreferringReadWriteLock lock;
+		auto uniqueGuard = CreateGuard(lock);
+	}
+
+	TEST_METHOD(Exclusion)
+	{
+		using namespace Echo;
+
+		CheckExclusion<ReaderPreferringPolicy>();
+		CheckExclusion<WriterPreferringPolicy>();
+		CheckExclusion<PhaseFairPolicy>();
+	}
+
+	TEST_METHOD(Upgrade)
+	{
+		using namespace Echo;
+
+		PhaseFairReadWriteLock lock;
+
+		{
+			PolicyReadWriteLockUpgradeGuard<PhaseFairPolicy> guard(lock);
+			Assert::IsFalse(guard.IsUpgraded());
+
+			// Readers can share with an upgrader, but another upgrader can't
+			Assert::IsTrue(lock.TryEnterShared());
+			Assert::IsFalse(lock.TryEnterUpgradeable());
+			lock.ExitShared();
+
+			guard.Upgrade();
+			Assert::IsTrue(guard.IsUpgraded());
+			Assert::IsFalse(lock.TryEnterShared());
+
+			guard.Downgrade();
+			Assert::IsFalse(guard.IsUpgraded());
+			Assert::IsTrue(lock.TryEnterShared());
+			lock.ExitShared();
+		}
+
+		Assert::IsTrue(lock.TryEnter());
+		lock.Exit();
+	}
+
+	TEST_METHOD(UpgradeWaitsForReaders)
+	{
+		using namespace Echo;
+
+		WriterPreferringReadWriteLock lock;
+		lock.EnterShared();
+
+		std::atomic<bool> upgraded(false);
+
+		Thread thread([&]
+		{
+			PolicyReadWriteLockUpgradeGuard<WriterPreferringPolicy> guard(lock);
+			guard.Upgrade();
+			upgraded = true;
+		});
+
+		thread.Start();
+		::Sleep(200);
+		Assert::IsFalse(upgraded.load());
+
+		lock.ExitShared();
+		thread.Wait();
+		Assert::IsTrue(upgraded.load());
+	}
+
+	TEST_METHOD(WriterPreferringUnderReadSaturation)
+	{
+		CheckWriterUnderReadSaturation<Echo::WriterPreferringPolicy>();
+	}
+
+	TEST_METHOD(PhaseFairUnderReadSaturation)
+	{
+		CheckWriterUnderReadSaturation<Echo::PhaseFairPolicy>();
+	}
+
+	TEST_METHOD(Contention)
+	{
+		using namespace Echo;
+
+		PhaseFairReadWriteLock lock;
+		long first=0;
+		long second=0;
+		std::atomic<bool> torn(false);
+
+		std::vector<Thread> threads;
+		for(int i=0; i<4; i++)
+		{
+			threads.emplace_back([&]
+			{
+				for(int j=0; j<10000; j++)
+				{
+					PolicyReadWriteLockSharedGuard<PhaseFairPolicy> guard(lock);
+					if(first!=second) torn=true;
+				}
+			});
+
+			threads.emplace_back([&]
+			{
+				for(int j=0; j<10000; j++)
+				{
+					Guard<PhaseFairReadWriteLock> guard(lock);
+					first++;
+					second++;
+				}
+			});
+		}
+
+		for(auto &thread : threads) thread.Start();
+		for(auto &thread : threads) thread.Wait();
+
+		Assert::IsFalse(torn.load());
+		Assert::AreEqual(40000L,first);
+		Assert::AreEqual(first,second);
+	}
+
+	TEST_METHOD(WaitOnConditionalVariable)
+	{
+		using namespace Echo;
+
+		PhaseFairReadWriteLock rwLock;
+		ConditionalVariable cv;
+
+		bool flag = false;
+
+		Thread thread([&]
+		{
+			::Sleep(1000);
+
+			Guard<PhaseFairReadWriteLock> guard(rwLock);
+			flag = true;
+			cv.NotifyAll();
+		});
+
+		thread.Start();
+
+		PolicyReadWriteLockSharedGuard<PhaseFairPolicy> guard(rwLock);
+		while(flag == false)
+		{
+			cv.WaitShared(rwLock, std::chrono::milliseconds(500));
+		}
+
+		Assert::AreEqual(true, flag);
+	}
+};
+
+} // end of namespace
\ No newline at end of file
@@ -0,0 +1,117 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+#include <Echo\QueueLock.h>
+#include <Echo\Thread.h>
+
+#include <vector>
+
+namespace EchoUnitTest 
+{
+
+TEST_CLASS(QueueLockTests)
+{
+private:
+	Echo::UniqueGuard<Echo::QueueLock> CreateGuard(Echo::QueueLock &lock)
+	{
+		using namespace Echo;
+		
+		UniqueGuard<QueueLock> guard(lock);
+		return guard;
+	}
+
+public:
+	TEST_METHOD(Construct)
+	{
+		using namespace Echo;
+
+		QueueLock lock;
+		Assert::AreEqual(QueueLock::DefaultSpinCount,lock.SpinCount());
+	}
+
+	TEST_METHOD(NodeIsCacheLineSized)
+	{
+		using namespace Echo;
+
+		Assert::AreEqual(CacheLineSize,alignof(QueueLock::Node));
+		Assert::AreEqual(CacheLineSize,sizeof(QueueLock::Node));
+	}
+
+	TEST_METHOD(TryEnter)
+	{
+		using namespace Echo;
+
+		QueueLock lock;
+		QueueLock::Node node;
+		QueueLock::Node other;
+
+		Assert::IsTrue(lock.TryEnter(node));
+		Assert::IsFalse(lock.TryEnter(other));
+		lock.Exit(node);
+
+		Assert::IsTrue(lock.TryEnter(other));
+		lock.Exit(other);
+	}
+
+	TEST_METHOD(Locking)
+	{
+		using namespace Echo;
+
+		QueueLock lock;
+		Guard<QueueLock> guard(lock);
+	}
+
+	TEST_METHOD(TryLocking)
+	{
+		using namespace Echo;
+
+		QueueLock lock;
+		
+		TryGuard<QueueLock> guard(lock);
+		Assert::IsTrue(guard.IsLocked());
+
+		TryGuard<QueueLock> other(lock);
+		Assert::IsFalse(other.IsLocked());
+	}
+
+	TEST_METHOD(UniqueLocking)
+	{
+		using namespace Echo;
+
+		QueueLock lock;
+		auto uniqueGuard = CreateGuard(lock);
+	}
+
+	TEST_METHOD(Contention)
+	{
+		using namespace Echo;
+
+		QueueLock lock(16);
+		long counter=0;
+
+		const int threadCount=16;
+		const int iterations=50000;
+
+		std::vector<Thread> threads;
+		for(int i=0; i<threadCount; i++)
+		{
+			threads.emplace_back([&]
+			{
+				for(int j=0; j<iterations; j++)
+				{
+					Guard<QueueLock> guard(lock);
+					counter++;
+				}
+			});
+		}
+
+		for(auto &thread : threads) thread.Start();
+		for(auto &thread : threads) thread.Wait();
+
+		Assert::AreEqual((long)threadCount*iterations,counter);
+	}
+};
+
+} // end of namespace
\ No newline at end of file
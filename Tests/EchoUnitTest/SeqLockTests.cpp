@@ -0,0 +1,101 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+#include <Echo\SeqLock.h>
+#include <Echo\Thread.h>
+
+#include <atomic>
+#include <vector>
+
+namespace EchoUnitTest 
+{
+
+TEST_CLASS(SeqLockTests)
+{
+private:
+	struct Quote
+	{
+		long long Bid;
+		long long Ask;
+	};
+
+public:
+	TEST_METHOD(Construct)
+	{
+		using namespace Echo;
+
+		SeqLock<int> lock(42);
+		Assert::AreEqual(42,lock.Load());
+		Assert::AreEqual((size_t)0,lock.Version());
+	}
+
+	TEST_METHOD(Store)
+	{
+		using namespace Echo;
+
+		SeqLock<int> lock;
+		lock.Store(10);
+
+		Assert::AreEqual(10,lock.Load());
+		Assert::AreEqual((size_t)2,lock.Version());
+	}
+
+	TEST_METHOD(ReadAndWrite)
+	{
+		using namespace Echo;
+
+		SeqLock<Quote> lock;
+
+		lock.Write([](Quote &quote)
+		{
+			quote.Bid=99;
+			quote.Ask=101;
+		});
+
+		auto spread=lock.Read([](const Quote &quote){return quote.Ask-quote.Bid;});
+		Assert::AreEqual(2LL,spread);
+	}
+
+	TEST_METHOD(ReadersNeverSeeTornWrites)
+	{
+		using namespace Echo;
+
+		SeqLock<Quote> lock(Quote{0,0});
+		std::atomic<bool> stop(false);
+		std::atomic<bool> torn(false);
+
+		std::vector<Thread> readers;
+		for(int i=0; i<4; i++)
+		{
+			readers.emplace_back([&]
+			{
+				while(!stop)
+				{
+					auto quote=lock.Load();
+					if(quote.Ask!=quote.Bid+1 && quote.Ask!=0) torn=true;
+				}
+			});
+		}
+
+		for(auto &reader : readers) reader.Start();
+
+		for(long long i=1; i<=100000; i++)
+		{
+			lock.Write([i](Quote &quote)
+			{
+				quote.Bid=i;
+				quote.Ask=i+1;
+			});
+		}
+
+		stop=true;
+		for(auto &reader : readers) reader.Wait();
+
+		Assert::IsFalse(torn);
+		Assert::AreEqual(100001LL,lock.Load().Ask);
+	}
+};
+
+} // end of namespace
\ No newline at end of file
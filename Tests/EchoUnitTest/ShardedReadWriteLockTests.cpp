@@ -0,0 +1,128 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+#include <Echo\ShardedReadWriteLock.h>
+#include <Echo\Environment.h>
+#include <Echo\Thread.h>
+
+#include <utility>
+#include <vector>
+
+namespace EchoUnitTest 
+{
+
+TEST_CLASS(ShardedReadWriteLockTests)
+{
+private:
+	Echo::UniqueGuard<Echo::ShardedReadWriteLock> CreateGuard(Echo::ShardedReadWriteLock &lock)
+	{
+		using namespace Echo;
+		
+		UniqueGuard<ShardedReadWriteLock> guard(lock);
+		return guard;
+	}
+
+public:
+	TEST_METHOD(Construct)
+	{
+		using namespace Echo;
+
+		ShardedReadWriteLock lock;
+		Assert::AreEqual(Environment::ProcessorCount(),lock.SlotCount());
+
+		ShardedReadWriteLock single(1);
+		Assert::AreEqual(DWORD(1),single.SlotCount());
+	}
+
+	TEST_METHOD(Locking)
+	{
+		using namespace Echo;
+
+		ShardedReadWriteLock lock;
+		Guard<ShardedReadWriteLock> guard(lock);
+	}
+
+	TEST_METHOD(SharedLocking)
+	{
+		using namespace Echo;
+
+		ShardedReadWriteLock lock;
+		ShardedReadWriteLockSharedGuard guard1(lock);
+		ShardedReadWriteLockSharedGuard guard2(lock);
+	}
+
+	TEST_METHOD(UniqueLocking)
+	{
+		using namespace Echo;
+
+		ShardedReadWriteLock lock;
+		auto uniqueGuard = CreateGuard(lock);
+	}
+
+	TEST_METHOD(TryEnter)
+	{
+		using namespace Echo;
+
+		ShardedReadWriteLock lock;
+		size_t slot=0;
+
+		Assert::IsTrue(lock.TryEnterShared(slot));
+		Assert::IsFalse(lock.TryEnter());
+		lock.ExitShared(slot);
+
+		Assert::IsTrue(lock.TryEnter());
+		Assert::IsFalse(lock.TryEnterShared(slot));
+		lock.Exit();
+	}
+
+	TEST_METHOD(Contention)
+	{
+		using namespace Echo;
+
+		ShardedReadWriteLock lock;
+		long first=0;
+		long second=0;
+		bool torn=false;
+
+		const int readerCount=8;
+		const int writerCount=2;
+		const int iterations=20000;
+
+		std::vector<Thread> threads;
+		for(int i=0; i<readerCount; i++)
+		{
+			threads.emplace_back([&]
+			{
+				for(int j=0; j<iterations; j++)
+				{
+					ShardedReadWriteLockSharedGuard guard(lock);
+					if(first!=second) torn=true;
+				}
+			});
+		}
+
+		for(int i=0; i<writerCount; i++)
+		{
+			threads.emplace_back([&]
+			{
+				for(int j=0; j<iterations; j++)
+				{
+					Guard<ShardedReadWriteLock> guard(lock);
+					first++;
+					second++;
+				}
+			});
+		}
+
+		for(auto &thread : threads) thread.Start();
+		for(auto &thread : threads) thread.Wait();
+
+		Assert::IsFalse(torn);
+		Assert::AreEqual((long)writerCount*iterations,first);
+		Assert::AreEqual(first,second);
+	}
+};
+
+} // end of namespace
\ No newline at end of file
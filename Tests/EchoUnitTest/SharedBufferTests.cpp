@@ -0,0 +1,167 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+#include <Echo\SharedBuffer.h>
+#include <Echo\BufferPool.h>
+#include <Echo\WorkDispatchQueue.h>
+#include <Echo\ThreadPool.h>
+#include <Echo\Events.h>
+
+#include <atomic>
+
+namespace EchoUnitTest 
+{
+
+TEST_CLASS(SharedBufferTests)
+{
+public:
+	static Echo::SharedBuffer MakeCounting(size_t size)
+	{
+		Echo::Buffer buffer(size);
+		auto data=buffer.DataAs<BYTE>();
+
+		for(size_t i=0; i<size; i++) data[i]=static_cast<BYTE>(i);
+
+		return Echo::SharedBuffer(std::move(buffer));
+	}
+
+	TEST_METHOD(Construct)
+	{
+		using namespace Echo;
+
+		Buffer buffer(16);
+		void *data=buffer.Data();
+
+		SharedBuffer shared(std::move(buffer));
+		Assert::IsTrue(shared.Data()==data);
+		Assert::AreEqual((size_t)16,shared.Size());
+		Assert::AreEqual(1L,shared.ReferenceCount());
+		Assert::IsNull(buffer.Data());
+	}
+
+	TEST_METHOD(Copy)
+	{
+		using namespace Echo;
+
+		auto shared=MakeCounting(16);
+
+		{
+			SharedBuffer copy=shared;
+			Assert::IsTrue(copy.Data()==shared.Data());
+			Assert::AreEqual(2L,shared.ReferenceCount());
+		}
+
+		Assert::AreEqual(1L,shared.ReferenceCount());
+
+		SharedBuffer moved(std::move(shared));
+		Assert::AreEqual(1L,moved.ReferenceCount());
+		Assert::IsFalse(static_cast<bool>(shared));
+	}
+
+	TEST_METHOD(Slice)
+	{
+		using namespace Echo;
+
+		auto shared=MakeCounting(100);
+		auto slice=shared.Slice(10,50);
+
+		Assert::AreEqual((size_t)50,slice.Size());
+		Assert::AreEqual((BYTE)10,slice.DataAs<BYTE>()[0]);
+		Assert::AreEqual(2L,shared.ReferenceCount());
+
+		// Slicing a slice is relative to the slice
+		auto inner=slice.Slice(5,10);
+		Assert::AreEqual((size_t)15,inner.Offset());
+		Assert::AreEqual((BYTE)15,inner.DataAs<BYTE>()[0]);
+
+		Assert::ExpectException<ArgumentException>([&]{shared.Slice(90,20);});
+		Assert::ExpectException<ArgumentException>([&]{slice.Slice(40,11);});
+	}
+
+	TEST_METHOD(SliceOutlivesBuffer)
+	{
+		using namespace Echo;
+
+		BufferSlice slice;
+
+		{
+			auto shared=MakeCounting(100);
+			slice=shared.Slice(90,10);
+		}
+
+		Assert::AreEqual(1L,slice.Source().ReferenceCount());
+		Assert::AreEqual((BYTE)99,slice.DataAs<BYTE>()[9]);
+	}
+
+	TEST_METHOD(PooledBuffer)
+	{
+		using namespace Echo;
+
+		BufferPool pool(64,64);
+		void *data=nullptr;
+
+		{
+			auto buffer=pool.Acquire();
+			data=buffer.Data();
+
+			SharedBuffer shared(std::move(buffer));
+			auto slice=shared.Slice(0,32);
+		}
+
+		// The last reference handed the buffer back to the pool
+		auto buffer=pool.Acquire();
+		Assert::IsTrue(buffer.Data()==data);
+	}
+
+	TEST_METHOD(AcrossQueues)
+	{
+		using namespace Echo;
+
+		class SumQueue : public WorkDispatchQueue<BufferSlice>
+		{
+		private:
+			std::atomic<long> &m_Total;
+			ManualResetEvent &m_Done;
+
+		protected:
+			void ProcessItem(BufferSlice &slice) override
+			{
+				long sum=0;
+				for(size_t i=0; i<slice.Size(); i++) sum+=slice.DataAs<BYTE>()[i];
+
+				m_Total+=sum;
+				m_Done.Set();
+			}
+
+		public:
+			SumQueue(IFunctionDispatcher &dispatcher, std::atomic<long> &total, ManualResetEvent &done) : WorkDispatchQueue(dispatcher), m_Total(total), m_Done(done)
+			{
+			}
+		};
+
+		ThreadPool pool;
+		pool.Start();
+
+		std::atomic<long> first(0), second(0);
+		ManualResetEvent firstDone(InitialState::NonSignalled), secondDone(InitialState::NonSignalled);
+
+		SumQueue firstQueue(pool,first,firstDone);
+		SumQueue secondQueue(pool,second,secondDone);
+
+		{
+			auto shared=MakeCounting(10);
+			firstQueue.Enqueue(shared.Slice(0,5));
+			secondQueue.Enqueue(shared.Slice(5,5));
+		}
+
+		firstDone.Wait();
+		secondDone.Wait();
+
+		Assert::AreEqual(0L+1+2+3+4,first.load());
+		Assert::AreEqual(5L+6+7+8+9,second.load());
+	}
+};
+
+} // end of namespace
\ No newline at end of file
@@ -0,0 +1,114 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+#include <Echo\SpinLock.h>
+#include <Echo\Thread.h>
+
+#include <utility>
+#include <vector>
+
+namespace EchoUnitTest 
+{
+
+TEST_CLASS(SpinLockTests)
+{
+private:
+	Echo::UniqueGuard<Echo::SpinLock> CreateGuard(Echo::SpinLock &lock)
+	{
+		using namespace Echo;
+		
+		UniqueGuard<SpinLock> guard(lock);
+		return guard;
+	}
+
+public:
+	TEST_METHOD(Construct)
+	{
+		using namespace Echo;
+
+		SpinLock lock;
+		Assert::AreEqual(SpinLock::DefaultSpinCount,lock.SpinCount());
+	}
+
+	TEST_METHOD(TryEnter)
+	{
+		using namespace Echo;
+
+		SpinLock lock;
+		Assert::IsTrue(lock.TryEnter());
+		Assert::IsFalse(lock.TryEnter());
+		lock.Exit();
+	}
+
+	TEST_METHOD(Locking)
+	{
+		using namespace Echo;
+
+		SpinLock lock;
+		Guard<SpinLock> guard(lock);
+	}
+
+	TEST_METHOD(TryLocking)
+	{
+		using namespace Echo;
+
+		SpinLock lock;
+		
+		TryGuard<SpinLock> guard(lock);
+		Assert::IsTrue(guard.IsLocked());
+
+		TryGuard<SpinLock> other(lock);
+		Assert::IsFalse(other.IsLocked());
+	}
+
+	TEST_METHOD(Unlocking)
+	{
+		using namespace Echo;
+
+		SpinLock lock;
+		Guard<SpinLock> guard(lock);
+		Unguard<SpinLock> unlock(lock);
+	}
+
+	TEST_METHOD(UniqueLocking)
+	{
+		using namespace Echo;
+
+		SpinLock lock;
+		auto uniqueGuard = CreateGuard(lock);
+	}
+
+	TEST_METHOD(Contention)
+	{
+		using namespace Echo;
+
+		// A tiny spin budget makes sure the parking path gets exercised
+		SpinLock lock(16);
+		long counter=0;
+
+		const int threadCount=8;
+		const int iterations=100000;
+
+		std::vector<Thread> threads;
+		for(int i=0; i<threadCount; i++)
+		{
+			threads.emplace_back([&]
+			{
+				for(int j=0; j<iterations; j++)
+				{
+					Guard<SpinLock> guard(lock);
+					counter++;
+				}
+			});
+		}
+
+		for(auto &thread : threads) thread.Start();
+		for(auto &thread : threads) thread.Wait();
+
+		Assert::AreEqual((long)threadCount*iterations,counter);
+	}
+};
+
+} // end of namespace
\ No newline at end of file
@@ -0,0 +1,145 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+#include <Echo\SpscRing.h>
+#include <Echo\Thread.h>
+
+#include <string>
+#include <vector>
+
+namespace EchoUnitTest 
+{
+
+TEST_CLASS(SpscRingTests)
+{
+public:
+	TEST_METHOD(Construct)
+	{
+		using namespace Echo;
+
+		SpscRing<int> ring(10);
+		Assert::AreEqual((size_t)16,ring.Capacity());
+		Assert::IsTrue(ring.IsEmpty());
+	}
+
+	TEST_METHOD(PushPop)
+	{
+		using namespace Echo;
+
+		SpscRing<std::string> ring(2);
+		Assert::IsTrue(ring.TryPush(std::string("one")));
+		Assert::IsTrue(ring.TryPush(std::string("two")));
+		Assert::IsFalse(ring.TryPush(std::string("three")));
+		Assert::AreEqual((size_t)2,ring.Size());
+
+		std::string value;
+		Assert::IsTrue(ring.TryPop(value));
+		Assert::AreEqual(std::string("one"),value);
+		Assert::IsTrue(ring.TryPop(value));
+		Assert::AreEqual(std::string("two"),value);
+		Assert::IsFalse(ring.TryPop(value));
+	}
+
+	TEST_METHOD(Batches)
+	{
+		using namespace Echo;
+
+		SpscRing<int> ring(8);
+		int input[]={1,2,3,4,5,6,7,8,9,10};
+
+		Assert::AreEqual((size_t)8,ring.TryPushN(input,10));
+
+		int output[10]={};
+		Assert::AreEqual((size_t)5,ring.TryPopN(output,5));
+		Assert::AreEqual(5,output[4]);
+
+		// Wraps around the end of the storage
+		Assert::AreEqual((size_t)2,ring.TryPushN(input+8,2));
+		Assert::AreEqual((size_t)5,ring.TryPopN(output,10));
+		Assert::AreEqual(6,output[0]);
+		Assert::AreEqual(10,output[4]);
+	}
+
+	TEST_METHOD(ClaimAndCommit)
+	{
+		using namespace Echo;
+
+		SpscRing<int> ring(4);
+		size_t claimed=0;
+
+		int *slots=ring.ClaimWrite(3,claimed);
+		Assert::AreEqual((size_t)3,claimed);
+		for(size_t i=0; i<claimed; i++) slots[i]=static_cast<int>(i)*10;
+
+		// Nothing is visible until it's committed
+		Assert::IsTrue(ring.IsEmpty());
+		ring.CommitWrite(claimed);
+
+		const int *items=ring.ClaimRead(4,claimed);
+		Assert::AreEqual((size_t)3,claimed);
+		Assert::AreEqual(20,items[2]);
+		ring.CommitRead(claimed);
+
+		// Only one slot remains before the wrap, so a contiguous claim is cut short
+		slots=ring.ClaimWrite(4,claimed);
+		Assert::AreEqual((size_t)1,claimed);
+		ring.CommitWrite(claimed);
+	}
+
+	TEST_METHOD(Handoff)
+	{
+		using namespace Echo;
+
+		SpscRing<unsigned> ring(1024);
+		const unsigned count=1000000;
+		bool inOrder=true;
+
+		Thread producer([&]
+		{
+			unsigned batch[64];
+			unsigned next=0;
+
+			while(next<count)
+			{
+				size_t size=0;
+				while(size<64 && next+size<count)
+				{
+					batch[size]=static_cast<unsigned>(next+size);
+					size++;
+				}
+
+				next+=static_cast<unsigned>(ring.TryPushN(batch,size));
+			}
+		});
+
+		Thread consumer([&]
+		{
+			unsigned expected=0;
+
+			while(expected<count)
+			{
+				size_t claimed=0;
+				const unsigned *items=ring.ClaimRead(64,claimed);
+
+				for(size_t i=0; i<claimed; i++)
+				{
+					if(items[i]!=expected++) inOrder=false;
+				}
+
+				ring.CommitRead(claimed);
+			}
+		});
+
+		producer.Start();
+		consumer.Start();
+		producer.Wait();
+		consumer.Wait();
+
+		Assert::IsTrue(inOrder);
+		Assert::IsTrue(ring.IsEmpty());
+	}
+};
+
+} // end of namespace
\ No newline at end of file
@@ -0,0 +1,139 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+#include <Echo\Strand.h>
+#include <Echo\ImmediateWorkItemDispatcher.h>
+#include <Echo\ThreadPool.h>
+#include <Echo\Events.h>
+#include <Echo\Exceptions.h>
+
+#include <atomic>
+#include <vector>
+
+namespace EchoUnitTest 
+{
+
+TEST_CLASS(StrandTests)
+{
+public:
+	TEST_METHOD(Immediate)
+	{
+		using namespace Echo;
+
+		ImmediateWorkItemDispatcher dispatcher;
+		Strand strand(dispatcher);
+
+		bool flag=false;
+
+		strand.Submit([&flag]{flag=true;});
+		Assert::IsTrue(flag);
+		Assert::AreEqual(0L,strand.Pending());
+	}
+
+	TEST_METHOD(Nested)
+	{
+		using namespace Echo;
+
+		ImmediateWorkItemDispatcher dispatcher;
+		Strand strand(dispatcher);
+
+		std::vector<int> order;
+
+		strand.Submit([&]
+		{
+			// This must not run until the outer function has finished
+			strand.Submit([&]{order.push_back(2);});
+			order.push_back(1);
+		});
+
+		Assert::AreEqual((size_t)2,order.size());
+		Assert::AreEqual(1,order[0]);
+		Assert::AreEqual(2,order[1]);
+	}
+
+	TEST_METHOD(DispatcherThrows)
+	{
+		using namespace Echo;
+
+		// Refuses work until told otherwise
+		class RefusingDispatcher : public IFunctionDispatcher
+		{
+		private:
+			ImmediateWorkItemDispatcher m_Inner;
+
+		public:
+			bool Refuse=true;
+
+			void Submit(const std::function<void()> &function) override
+			{
+				if(Refuse) throw Exception(_T("dispatcher refused"));
+				m_Inner.Submit(function);
+			}
+		};
+
+		RefusingDispatcher dispatcher;
+		int ran=0;
+
+		{
+			Strand strand(dispatcher);
+
+			Assert::ExpectException<Exception>([&]{strand.Submit([&]{ran+=1;});});
+			Assert::AreEqual(0L,strand.Pending());
+
+			// The strand must be idle again, so the next submission schedules it
+			dispatcher.Refuse=false;
+			strand.Submit([&]{ran+=10;});
+
+			Assert::AreEqual(10,ran);
+			Assert::AreEqual(0L,strand.Pending());
+		}
+	}
+
+	TEST_METHOD(OnThreadPool)
+	{
+		using namespace Echo;
+
+		ThreadPool pool;
+		pool.MinimumThreads(4);
+		pool.MaximumThreads(8);
+		pool.Start();
+
+		ManualResetEvent event(InitialState::NonSignalled);
+
+		const int count=10000;
+		std::vector<int> order;
+		std::atomic<int> running(0);
+		std::atomic<bool> overlapped(false);
+
+		{
+			Strand strand(pool);
+
+			for(int i=0; i<count; i++)
+			{
+				strand.Submit([&,i]
+				{
+					if(running.fetch_add(1)!=0) overlapped=true;
+
+					order.push_back(i);
+					if(i==count-1) event.Set();
+
+					running.fetch_sub(1);
+				});
+			}
+
+			event.Wait();
+		}
+
+		Assert::IsFalse(overlapped);
+		Assert::AreEqual((size_t)count,order.size());
+
+		for(int i=0; i<count; i++)
+		{
+			Assert::AreEqual(i,order[i]);
+		}
+	}
+};
+
+} // end of namespace
\ No newline at end of file
@@ -0,0 +1,97 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+#include <Echo\Thread.h>
+#include <Echo\ThreadPool.h>
+#include <Echo\ThreadOptions.h>
+#include <Echo\Events.h>
+
+#include <atomic>
+
+namespace EchoUnitTest 
+{
+
+TEST_CLASS(ThreadOptionsTests)
+{
+public:
+	TEST_METHOD(Defaults)
+	{
+		using namespace Echo;
+
+		ThreadOptions options;
+		Assert::IsTrue(options.AffinityMask()==0);
+		Assert::AreEqual(THREAD_PRIORITY_NORMAL,options.Priority());
+		Assert::AreEqual(0u,options.StackSize());
+		Assert::IsTrue(options.Name().empty());
+	}
+
+	TEST_METHOD(ThreadPriority)
+	{
+		using namespace Echo;
+
+		ThreadOptions options;
+		options.Priority(THREAD_PRIORITY_ABOVE_NORMAL);
+		options.Name(_T("Echo test thread"));
+
+		int priority=THREAD_PRIORITY_NORMAL;
+
+		Thread thread([&priority]
+		{
+			priority=::GetThreadPriority(::GetCurrentThread());
+		}, options);
+
+		thread.Start();
+		thread.Wait();
+
+		Assert::AreEqual(THREAD_PRIORITY_ABOVE_NORMAL,priority);
+	}
+
+	TEST_METHOD(ThreadAffinity)
+	{
+		using namespace Echo;
+
+		ThreadOptions options;
+		options.AffinityMask(1);
+		options.StackSize(64*1024);
+
+		DWORD processor=0xffffffff;
+
+		Thread thread([&processor]
+		{
+			processor=::GetCurrentProcessorNumber();
+		}, options);
+
+		thread.Start();
+		thread.Wait();
+
+		Assert::AreEqual((DWORD)0,processor);
+	}
+
+	TEST_METHOD(ThreadPoolPriority)
+	{
+		using namespace Echo;
+
+		ThreadOptions options;
+		options.Priority(THREAD_PRIORITY_BELOW_NORMAL);
+		options.StackSize(128*1024);
+
+		std::atomic<int> priority(THREAD_PRIORITY_NORMAL);
+		ManualResetEvent event(InitialState::NonSignalled);
+
+		ThreadPool pool(options);
+		pool.Start();
+
+		pool.Submit([&]
+		{
+			priority=::GetThreadPriority(::GetCurrentThread());
+			event.Set();
+		});
+
+		event.Wait();
+		Assert::AreEqual(THREAD_PRIORITY_BELOW_NORMAL,priority.load());
+	}
+};
+
+} // end of namespace
\ No newline at end of file
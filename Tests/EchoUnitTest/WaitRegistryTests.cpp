@@ -0,0 +1,214 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+#include <Echo\WaitRegistry.h>
+#include <Echo\ThreadPool.h>
+#include <Echo\Events.h>
+#include <Echo\LightSemaphore.h>
+#include <Echo\Exceptions.h>
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+namespace EchoUnitTest 
+{
+
+TEST_CLASS(WaitRegistryTests)
+{
+public:
+	TEST_METHOD(Construct)
+	{
+		using namespace Echo;
+
+		WaitRegistry registry;
+		Assert::AreEqual((size_t)0,registry.Count());
+	}
+
+	TEST_METHOD(MoreThanSixtyFourHandles)
+	{
+		using namespace Echo;
+
+		const int count=200;
+
+		std::vector<std::unique_ptr<AutoResetEvent>> events;
+		for(int i=0; i<count; i++)
+		{
+			events.emplace_back(new AutoResetEvent(InitialState::NonSignalled));
+		}
+
+		LightSemaphore fired(0,count);
+		std::vector<std::atomic<int>> hits(count);
+
+		WaitRegistry registry;
+		for(int i=0; i<count; i++)
+		{
+			registry.Register(*events[i], [&,i]
+			{
+				hits[i]++;
+				fired.Release();
+			});
+		}
+
+		Assert::AreEqual((size_t)count,registry.Count());
+
+		for(auto &event : events) event->Set();
+		Assert::IsTrue(fired.Acquire(count,std::chrono::seconds(10)));
+
+		for(int i=0; i<count; i++)
+		{
+			Assert::AreEqual(1,hits[i].load());
+		}
+	}
+
+	TEST_METHOD(Rearms)
+	{
+		using namespace Echo;
+
+		AutoResetEvent event(InitialState::NonSignalled);
+		LightSemaphore fired(0,1);
+
+		WaitRegistry registry;
+		registry.Register(event, [&]{fired.Release();});
+
+		for(int i=0; i<5; i++)
+		{
+			event.Set();
+			Assert::IsTrue(fired.Acquire(1,std::chrono::seconds(5)));
+		}
+	}
+
+	TEST_METHOD(Unregister)
+	{
+		using namespace Echo;
+
+		AutoResetEvent event(InitialState::NonSignalled);
+		std::atomic<int> hits(0);
+
+		WaitRegistry registry;
+		auto cookie=registry.Register(event, [&]{hits++;});
+
+		Assert::IsTrue(registry.Unregister(cookie));
+		Assert::IsFalse(registry.Unregister(cookie));
+		Assert::AreEqual((size_t)0,registry.Count());
+
+		event.Set();
+		::Sleep(200);
+		Assert::AreEqual(0,hits.load());
+	}
+
+	TEST_METHOD(OnDispatcher)
+	{
+		using namespace Echo;
+
+		ThreadPool pool;
+		pool.Start();
+
+		ManualResetEvent done(InitialState::NonSignalled);
+		AutoResetEvent event(InitialState::NonSignalled);
+
+		WaitRegistry registry(pool);
+		registry.Register(event, [&]{done.Set();});
+
+		event.Set();
+		Assert::IsTrue(done.Wait(std::chrono::seconds(5)));
+
+		registry.Clear();
+	}
+
+	TEST_METHOD(RearmsAfterCallbackThrows)
+	{
+		using namespace Echo;
+
+		AutoResetEvent event(InitialState::NonSignalled);
+		LightSemaphore fired(0,2);
+		std::atomic<int> calls(0);
+
+		WaitRegistry registry;
+		registry.Register(event, [&]
+		{
+			fired.Release();
+			if(calls++==0) throw Exception(_T("callback failed"));
+		});
+
+		event.Set();
+		Assert::IsTrue(fired.Acquire(1,std::chrono::seconds(5)));
+
+		event.Set();
+		Assert::IsTrue(fired.Acquire(1,std::chrono::seconds(5)));
+	}
+
+	TEST_METHOD(UnregisterWaitsForDispatchedCallback)
+	{
+		using namespace Echo;
+
+		ThreadPool pool;
+		pool.Start();
+
+		ManualResetEvent started(InitialState::NonSignalled);
+		AutoResetEvent event(InitialState::NonSignalled);
+		std::atomic<bool> finished(false);
+
+		WaitRegistry registry(pool);
+		auto cookie=registry.Register(event, [&]
+		{
+			started.Set();
+			::Sleep(200);
+			finished=true;
+		});
+
+		event.Set();
+		Assert::IsTrue(started.Wait(std::chrono::seconds(5)));
+
+		registry.Unregister(cookie);
+		Assert::IsTrue(finished.load());
+	}
+
+	TEST_METHOD(DispatcherThrows)
+	{
+		using namespace Echo;
+
+		// Turns down the first call, then hands the rest to the pool
+		class FailOnceDispatcher : public IFunctionDispatcher
+		{
+		private:
+			IFunctionDispatcher &m_Inner;
+
+		public:
+			std::atomic<int> Failures;
+
+			FailOnceDispatcher(IFunctionDispatcher &inner) : m_Inner(inner), Failures(0)
+			{
+			}
+
+			void Submit(const std::function<void()> &function) override
+			{
+				if(Failures.exchange(1)==0) throw Exception(_T("dispatcher failed"));
+				m_Inner.Submit(function);
+			}
+		};
+
+		ThreadPool pool;
+		pool.Start();
+
+		FailOnceDispatcher dispatcher(pool);
+		ManualResetEvent done(InitialState::NonSignalled);
+		AutoResetEvent event(InitialState::NonSignalled);
+
+		WaitRegistry registry(dispatcher);
+		registry.Register(event, [&]{done.Set();});
+
+		event.Set();
+		while(dispatcher.Failures.load()==0) ::Sleep(10);
+
+		// The failed dispatch must leave the registration watching the handle
+		event.Set();
+		Assert::IsTrue(done.Wait(std::chrono::seconds(5)));
+
+		registry.Clear();
+	}
+};
+
+} // end of namespace
\ No newline at end of file
@@ -7,6 +7,8 @@ using namespace Microsoft::VisualStudio::CppUnitTestFramework;
 #include <Echo\ImmediateWorkItemDispatcher.h>
 #include <Echo\ThreadPool.h>
 #include <Echo\Events.h>
+#include <Echo\SpinLock.h>
+#include <Echo\MonotonicArena.h>
 
 #include <atomic>
 
@@ -50,6 +52,62 @@ public:
 		event.Wait();
 		Assert::IsTrue(flag);
 	}
+
+	TEST_METHOD(SpinLockPolicy)
+	{
+		using namespace Echo;
+
+		class SpinLockQueue : public WorkDispatchQueue<int, SpinLock>
+		{
+		private:
+			long &m_Total;
+
+		protected:
+			void ProcessItem(int &item) override
+			{
+				m_Total += item;
+			}
+
+		public:
+			SpinLockQueue(IFunctionDispatcher &dispatcher, long &total) : WorkDispatchQueue(dispatcher), m_Total(total)
+			{
+			}
+		};
+
+		ImmediateWorkItemDispatcher dispatcher;
+		long total=0;
+
+		SpinLockQueue queue(dispatcher, total);
+		queue.Enqueue(1);
+		queue.Enqueue(2);
+
+		Assert::AreEqual(3L,total);
+	}
+
+	TEST_METHOD(ArenaPerActivation)
+	{
+		using namespace Echo;
+
+		ImmediateWorkItemDispatcher dispatcher;
+		FunctionWorkDispatchQueue queue(dispatcher);
+
+		MonotonicArena *arena=nullptr;
+		size_t allocated=0;
+
+		queue.Enqueue([&]
+		{
+			arena=MonotonicArena::Current();
+			arena->Allocate(100);
+			allocated=arena->BytesAllocated();
+		});
+
+		Assert::IsNotNull(arena);
+		Assert::AreEqual((size_t)100,allocated);
+
+		// The arena is reset and no longer current once the activation ends
+		Assert::AreEqual((size_t)0,arena->BytesAllocated());
+		Assert::IsNull(MonotonicArena::Current());
+	}
 };
 
 } // end of namespace
\ No newline at end of file